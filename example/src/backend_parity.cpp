@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "glShow2d.h"
+
+namespace
+{
+// Gradients with a checkerboard corner, so both smooth areas and hard edges
+// go through the image filtering of each backend.
+std::vector<unsigned char> MakeTestImage(int const width, int const height)
+{
+    std::vector<unsigned char> image(static_cast<std::size_t>(width) * height *
+                                     3);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            unsigned char* const pixel =
+                image.data() + (static_cast<std::size_t>(y) * width + x) * 3;
+            bool const checker = x < width / 4 && y < height / 4;
+            if (checker)
+            {
+                unsigned char const value =
+                    ((x / 8 + y / 8) % 2) != 0 ? 255 : 0;
+                std::fill_n(pixel, 3, value);
+            }
+            else
+            {
+                pixel[0] = static_cast<unsigned char>(x * 255 / (width - 1));
+                pixel[1] = static_cast<unsigned char>(y * 255 / (height - 1));
+                pixel[2] = static_cast<unsigned char>(
+                    (x + y) * 255 / (width + height - 2));
+            }
+        }
+    }
+    return image;
+}
+
+void DrawLabels(glShow::glShow2d& display)
+{
+    display.DrawText("glShow2d backend parity", 20.0f, 300.0f, 1.0f,
+                     {1.0f, 1.0f, 1.0f});
+    display.DrawText("0123456789 +-*/ ()[]{}", 20.0f, 200.0f, 0.75f,
+                     {1.0f, 0.5f, 0.0f});
+    display.DrawText("small text", 20.0f, 100.0f, 0.4f, {0.0f, 0.0f, 0.0f});
+}
+
+// Prints the largest absolute difference of each channel and how many
+// pixels differ by more than tolerance in any channel
+void ReportDifference(std::string const& name,
+                      std::vector<unsigned char> const& window,
+                      std::vector<unsigned char> const& software,
+                      int const tolerance)
+{
+    std::array<int, 3> maxDiff{};
+    std::size_t outliers = 0;
+    for (std::size_t i = 0; i < window.size(); i += 3)
+    {
+        bool outlier = false;
+        for (int c = 0; c < 3; ++c)
+        {
+            int const diff =
+                std::abs(int(window[i + c]) - int(software[i + c]));
+            maxDiff[c] = std::max(maxDiff[c], diff);
+            outlier = outlier || diff > tolerance;
+        }
+        outliers += outlier ? 1 : 0;
+    }
+
+    std::cout << name << ": max difference r " << maxDiff[0] << ", g "
+              << maxDiff[1] << ", b " << maxDiff[2] << ", " << outliers
+              << " of " << window.size() / 3 << " pixels off by more than "
+              << tolerance << '\n';
+}
+} // namespace
+
+// Renders the same image and labels through the window and the software
+// renderer and compares the results. Usage: backend_parity [font]
+int main(int argc, char* argv[])
+{
+    constexpr int width = 640;
+    constexpr int height = 360;
+    constexpr int tolerance = 2;
+    std::string const fontPath =
+        argc > 1 ? argv[1] : "D:\\Programming\\OpenGL\\fonts\\bitter.otf";
+
+    // image and frame are the same size, so neither backend resamples
+    std::vector<unsigned char> const image = MakeTestImage(width, height);
+    std::vector<unsigned char> target(image.size());
+    std::vector<unsigned char> windowFrame(image.size());
+    std::vector<unsigned char> softwareFrame(image.size());
+
+    try
+    {
+        glShow::glShow2d window(width, height, "backend parity", fontPath);
+        glShow::glShow2d software(target.data(), width, height, 3, fontPath);
+
+        auto const compare = [&](std::string const& name, bool const labels) {
+            for (glShow::glShow2d* const display : {&window, &software})
+            {
+                if (labels)
+                {
+                    DrawLabels(*display);
+                }
+                display->Draw(image.data(), width, height, 3);
+            }
+            if (!window.ReadFrame(windowFrame.data(), width, height) ||
+                !software.ReadFrame(softwareFrame.data(), width, height))
+            {
+                std::cout << name << ": framebuffer smaller than the frame\n";
+                return;
+            }
+            ReportDifference(name, windowFrame, softwareFrame, tolerance);
+        };
+
+        compare("image", false);
+        compare("image and labels", true);
+
+        // BC7 is window renderer only, the software target must keep the
+        // last frame. Any 16 bytes are a valid block, mode 6 here.
+        std::vector<unsigned char> bc7((width / 4) * (height / 4) * 16);
+        for (std::size_t i = 0; i < bc7.size(); i += 16)
+        {
+            bc7[i] = 0x40;
+        }
+        std::vector<unsigned char> const before = target;
+        software.DrawCompressed(bc7.data(), bc7.size(), width, height,
+                                glShow::glShow2d::CompressedFormat::BC7);
+        std::cout << "BC7: software target "
+                  << (target == before ? "unchanged" : "changed, unexpected")
+                  << '\n';
+    }
+    catch (std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
@@ -11,6 +11,10 @@ int main()
 {
     std::string const fontPath{"D:\\Programming\\OpenGL\\fonts\\bitter.otf"};
     glShow::glShow2d display(800, 600, "new window", fontPath);
+    auto const startup = display.GetStartupTimings();
+    std::cout << "startup " << startup.total << " ms, font waited "
+              << startup.fontWait << " ms, " << startup.programsFromCache
+              << " programs from cache\n";
     std::string const filename{"C:\\Users\\SNaKeRUBIN\\Desktop\\blue.png"};
 
     // flip images for stb_image
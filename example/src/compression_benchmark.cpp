@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glShow2d.h"
+#include "glShow2dCompression.h"
+#include "glShow2dParallel.h"
+
+namespace
+{
+using Clock = std::chrono::high_resolution_clock;
+using Milliseconds = std::chrono::duration<float, std::milli>;
+
+// Smooth gradients with a band of fine detail, so both flat and busy blocks
+// are represented.
+std::vector<unsigned char> MakeTestImage(int const width, int const height,
+                                         int const nChannels)
+{
+    std::vector<unsigned char> image(static_cast<std::size_t>(width) * height *
+                                     nChannels);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            bool const detail = y > height / 3 && y < 2 * height / 3;
+            for (int c = 0; c < nChannels; ++c)
+            {
+                int value = (x * (c + 1) + y * c) * 255 /
+                            (width * (c + 1) + height * c);
+                if (detail)
+                {
+                    value = ((x / 3 + y / 5 + c) % 7) * 36;
+                }
+                image[(static_cast<std::size_t>(y) * width + x) * nChannels +
+                      c] = static_cast<unsigned char>(value);
+            }
+        }
+    }
+    return image;
+}
+
+float PSNR(std::vector<unsigned char> const& reference, int const refChannels,
+           std::vector<unsigned char> const& decoded, int const decChannels,
+           int const nChannels)
+{
+    std::size_t const nPixels = reference.size() / refChannels;
+    double squaredError = 0.0;
+    for (std::size_t i = 0; i < nPixels; ++i)
+    {
+        for (int c = 0; c < nChannels; ++c)
+        {
+            double const diff = double(reference[i * refChannels + c]) -
+                                double(decoded[i * decChannels + c]);
+            squaredError += diff * diff;
+        }
+    }
+    double const mse = squaredError / (nPixels * nChannels);
+    if (mse == 0.0)
+    {
+        return INFINITY;
+    }
+    return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / mse));
+}
+
+template <typename Fn>
+float TimePerIteration(int const iterations, Fn const& fn)
+{
+    auto const start = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    return Milliseconds(Clock::now() - start).count() / iterations;
+}
+} // namespace
+
+int main()
+{
+    constexpr int width = 3840;
+    constexpr int height = 2160;
+    constexpr int iterations = 100;
+    float const megaPixels = width * height / 1.0e6f;
+
+    std::vector<unsigned char> const rgb = MakeTestImage(width, height, 3);
+    std::vector<unsigned char> const gray = MakeTestImage(width, height, 1);
+
+    using glShow::impl::BlockFormat;
+    std::vector<unsigned char> bc1(
+        glShow::impl::CompressedImageSize(BlockFormat::BC1, width, height));
+    std::vector<unsigned char> bc4(
+        glShow::impl::CompressedImageSize(BlockFormat::BC4, width, height));
+
+    // encoder quality
+    std::vector<unsigned char> decodedRGB(rgb.size());
+    std::vector<unsigned char> decodedGray(gray.size());
+    glShow::impl::WorkerPool pool;
+    pool.Start(0);
+    glShow::impl::CompressBC1(rgb.data(), width, height, 3, bc1.data(), pool);
+    glShow::impl::DecompressBC1(bc1.data(), width, height, decodedRGB.data());
+    glShow::impl::CompressBC4(gray.data(), width, height, 1, bc4.data(), pool);
+    glShow::impl::DecompressBC4(bc4.data(), width, height, decodedGray.data());
+
+    std::cout << "image " << width << 'x' << height << '\n';
+    std::cout << "BC1 " << rgb.size() / bc1.size() << ":1, PSNR "
+              << PSNR(rgb, 3, decodedRGB, 3, 3) << " dB\n";
+    std::cout << "BC4 " << gray.size() / bc4.size() << ":1, PSNR "
+              << PSNR(gray, 1, decodedGray, 1, 1) << " dB\n";
+
+    // encoder throughput
+    unsigned const maxThreads =
+        std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned nThreads = 1; nThreads <= maxThreads; nThreads *= 2)
+    {
+        pool.Start(nThreads);
+        float const bc1Time = TimePerIteration(10, [&]() {
+            glShow::impl::CompressBC1(rgb.data(), width, height, 3, bc1.data(),
+                                      pool);
+        });
+        float const bc4Time = TimePerIteration(10, [&]() {
+            glShow::impl::CompressBC4(gray.data(), width, height, 1,
+                                      bc4.data(), pool);
+        });
+        std::cout << nThreads << " thread(s): BC1 " << bc1Time << " ms ("
+                  << megaPixels / bc1Time * 1000.0f << " MPix/s), BC4 "
+                  << bc4Time << " ms (" << megaPixels / bc4Time * 1000.0f
+                  << " MPix/s)\n";
+    }
+
+    // end to end frame time of each upload path
+    try
+    {
+        glShow::glShow2d display(1280, 720, "compression benchmark");
+
+        float const uncompressed = TimePerIteration(iterations, [&]() {
+            display.Draw(rgb.data(), width, height, 3);
+        });
+
+        float const precompressed = TimePerIteration(iterations, [&]() {
+            display.DrawCompressed(
+                bc1.data(), bc1.size(), width, height,
+                glShow::glShow2d::CompressedFormat::BC1);
+        });
+
+        display.EnableUploadCompression();
+        float const cpuCompressed = TimePerIteration(iterations, [&]() {
+            display.Draw(rgb.data(), width, height, 3);
+        });
+        display.DisableUploadCompression();
+
+        std::cout << "Draw, uncompressed:          " << uncompressed
+                  << " ms/frame\n";
+        std::cout << "DrawCompressed, BC1:         " << precompressed
+                  << " ms/frame\n";
+        std::cout << "Draw, cpu BC1 upload:        " << cpuCompressed
+                  << " ms/frame\n";
+    }
+    catch (std::exception& e)
+    {
+        std::cout << e.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
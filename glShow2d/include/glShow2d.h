@@ -1,5 +1,11 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace glShow
 {
@@ -12,18 +18,123 @@ class glShow2d final
     glShow2d(unsigned const width, unsigned const height,
              std::string const& windowName, std::string const& pathToFont);
 
+    // Software renderer, no window or GL context is created. Every Draw
+    // composites the image and queued text into target, which must hold
+    // width * height * nChannels bytes (3 or 4 channels), bottom row first.
+    // Frames are composited by nThreads threads including the caller, 0
+    // uses all hardware threads.
+    glShow2d(unsigned char* const target, unsigned const width,
+             unsigned const height, int const nChannels,
+             unsigned const nThreads = 0);
+
+    glShow2d(unsigned char* const target, unsigned const width,
+             unsigned const height, int const nChannels,
+             std::string const& pathToFont, unsigned const nThreads = 0);
+
     void Draw(unsigned char const* const data, int const width,
               int const height, int const nChannels);
 
+    // Pre-compressed 4x4 block formats, uploaded without conversion. The
+    // software renderer cannot decode BC7 and leaves its target unchanged.
+    enum class CompressedFormat
+    {
+        BC1, // rgb, 8 bytes per block
+        BC4, // single channel, 8 bytes per block
+        BC7  // rgba, 16 bytes per block, window renderer only
+    };
+    void DrawCompressed(unsigned char const* const data,
+                        std::size_t const size, int const width,
+                        int const height, CompressedFormat const format);
+
+    // Compress frames passed to Draw on the cpu before uploading them, BC4
+    // for 1, BC1 for 3 and BC3 for 4 channel images. The encoder threads
+    // are started here and stopped by DisableUploadCompression, nThreads of
+    // 0 uses all hardware threads.
+    void EnableUploadCompression(unsigned const nThreads = 0);
+
+    void DisableUploadCompression();
+
     struct TextColor
     {
         float r, g, b;
     };
-    void DrawText(std::string const& text, float const x, float const y,
+    // text is copied, it does not need to outlive the call. x and y are in
+    // pixels from the bottom left of the window or target.
+    void DrawText(std::string_view const text, float const x, float const y,
                   float const scale, TextColor const& color);
 
     void EnableOrReInitTextRenderer(std::string const& pathToFont);
 
+    // GL calls issued during the last frame by category. elided counts the
+    // calls skipped because the state they set was already current.
+    struct GLCallCounts
+    {
+        unsigned program, vertexArray, buffer, texture, upload, uniform,
+            pixelStore, draw, framebuffer, blend, sync;
+        unsigned elided;
+    };
+    GLCallCounts GetGLCallCounts() const;
+
+    // Milliseconds spent constructing this object. The font is rasterized on
+    // a worker thread while the window, context and programs are created, so
+    // fontWait is the part of fontRasterization that was not hidden.
+    // Programs are loaded from a binary cache in the temp directory when the
+    // driver supports it, programsFromCache tells how many were.
+    struct StartupTimings
+    {
+        float window, glLoader, textureSetup, shaderPrograms,
+            fontRasterization, fontWait, atlasUpload, total;
+        unsigned programsFromCache;
+    };
+    StartupTimings GetStartupTimings() const;
+
+    // Per channel 256 bin histogram of the displayed image and the numbers
+    // derived from it. Only the first nChannels entries are valid. The
+    // window renderer accumulates counts in 32 bit floats, which stop at
+    // 2^24 (16777216) pixels per bin. Such bins are clamped there and flag
+    // their channel as saturated, its mean is then skewed towards the other
+    // values. Only images above 16.7 megapixels can saturate, the software
+    // renderer counts exactly.
+    struct PixelStats
+    {
+        int nChannels;
+        std::array<std::array<std::uint32_t, 256>, 4> histogram;
+        std::array<float, 4> mean;
+        std::array<unsigned char, 4> min, max;
+        std::array<std::uint32_t, 4> clippedLow, clippedHigh; // at 0 and 255
+        std::array<bool, 4> saturated;
+    };
+
+    // The window renderer histograms the uploaded texture on the gpu and
+    // reads the results back without stalling, so they trail the displayed
+    // frame by at least one frame. overlay draws the histogram in the bottom
+    // left corner, with a line of numbers per channel when text is enabled.
+    // The software renderer computes the stats of each frame as it is
+    // drawn and has no overlay.
+    void EnablePixelStats(bool const overlay = false);
+
+    void DisablePixelStats();
+
+    // Returns false until the first results are available
+    bool GetPixelStats(PixelStats& stats) const;
+
+    // Copies the bottom left width x height pixels of the last frame into
+    // dst as tightly packed rgb, bottom row first. Returns false if the
+    // window framebuffer or the software target is smaller.
+    bool ReadFrame(unsigned char* const dst, unsigned const width,
+                   unsigned const height);
+
+    // Sleeps until window events arrive or timeoutSeconds pass (negative
+    // waits indefinitely). The last drawn image and text are redisplayed
+    // on resize and expose, so a paused producer costs no cpu and the
+    // window stays correct. Throws like Draw once the window is closed.
+    // The software renderer has no events and only returns on WakeUp or
+    // when the timeout passes.
+    void WaitEvents(double const timeoutSeconds = -1.0);
+
+    // Makes a pending WaitEvents return, callable from any thread
+    void WakeUp();
+
     ~glShow2d() noexcept;
 
   private:
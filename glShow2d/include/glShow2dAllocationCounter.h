@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace glShow
+{
+namespace impl
+{
+// Counts global operator new calls made on the current thread while an
+// AllocationScope is alive. Counting needs the global allocation functions
+// replaced, so it is only compiled in with GLSHOW2D_COUNT_ALLOCATIONS;
+// otherwise scopes are free and the count stays 0.
+class AllocationScope
+{
+  public:
+    AllocationScope();
+    ~AllocationScope();
+
+    AllocationScope(AllocationScope const&) = delete;
+    AllocationScope& operator=(AllocationScope const&) = delete;
+};
+
+// Running total of counted allocations on the current thread
+std::size_t CountedAllocations();
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string_view>
+
+namespace glShow
+{
+namespace impl
+{
+// Types shared by the GL and software backends, so the public wrappers can
+// treat both the same way
+
+struct TextColor
+{
+    float r, g, b;
+};
+
+// text points into the frame arena and is only valid until the frame ends
+struct TextToRender
+{
+    std::string_view text;
+    float x, y;
+    float scale;
+    TextColor color;
+};
+
+// Milliseconds spent in each step of construction
+struct StartupTimings
+{
+    float window;            // glfw init and window creation
+    float glLoader;          // glad, default state, program cache
+    float textureSetup;      // image quad and texture
+    float shaderPrograms;    // compiling or loading both programs
+    float fontRasterization; // FreeType, on a worker thread
+    float fontWait;          // blocked waiting for the worker
+    float atlasUpload;
+    float total;
+    unsigned programsFromCache;
+};
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+namespace glShow
+{
+namespace impl
+{
+class WorkerPool;
+
+// 4x4 block compressed formats accepted by glShow2d::DrawCompressed.
+// BC1 and BC4 can also be produced by the built-in encoder below, BC3 is
+// only produced by it for rgba uploads.
+enum class BlockFormat
+{
+    BC1, // 8 bytes per block, rgb
+    BC3, // 16 bytes per block, BC4 alpha block then BC1 color block
+    BC4, // 8 bytes per block, single channel
+    BC7  // 16 bytes per block, rgba
+};
+
+std::size_t BlockSize(BlockFormat const format);
+
+std::size_t CompressedImageSize(BlockFormat const format, int const width,
+                                int const height);
+
+// Real-time bounding box encoders. Source is tightly packed 8 bit data with
+// nChannels interleaved channels, dst must hold CompressedImageSize bytes.
+// Block rows are split across the threads of pool.
+void CompressBC1(unsigned char const* const src, int const width,
+                 int const height, int const nChannels,
+                 unsigned char* const dst, WorkerPool& pool);
+
+// Alpha is taken from channel 3, or is opaque for fewer channels
+void CompressBC3(unsigned char const* const src, int const width,
+                 int const height, int const nChannels,
+                 unsigned char* const dst, WorkerPool& pool);
+
+void CompressBC4(unsigned char const* const src, int const width,
+                 int const height, int const nChannels,
+                 unsigned char* const dst, WorkerPool& pool);
+
+// Reference decoders, used to measure encoder quality. Output is tightly
+// packed rgb for BC1 and single channel for BC4.
+void DecompressBC1(unsigned char const* const src, int const width,
+                   int const height, unsigned char* const dst);
+
+void DecompressBC4(unsigned char const* const src, int const width,
+                   int const height, unsigned char* const dst);
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace glShow
+{
+namespace impl
+{
+struct uivec2
+{
+    unsigned x, y;
+};
+
+struct ivec2
+{
+    int x, y;
+};
+
+struct Character
+{
+    uivec2 Size;   // Size of glyph
+    ivec2 Bearing; // Offset from baseline to left/top of glyph
+    ivec2 Advance; // Offset to advance to next glyph
+    uivec2 Offset; // Offset to char in tex atlas in range [0.0, 1.0]
+};
+
+// Single channel coverage bitmaps of the printable ascii glyphs packed side
+// by side, top row first. Shared by the GL and software text renderers.
+struct GlyphAtlas
+{
+    unsigned width, height;
+    std::vector<unsigned char> pixels;
+    std::map<char, Character> characters;
+};
+
+GlyphAtlas RasterizeGlyphAtlas(std::string const& pathToFont);
+
+// Glyph of c, '?' for characters outside the atlas and nullptr if the atlas
+// has neither, e.g. because the font failed to load
+inline Character const* FindGlyph(GlyphAtlas const& atlas, char const c)
+{
+    auto it = atlas.characters.find(c);
+    if (it == atlas.characters.end())
+    {
+        it = atlas.characters.find('?');
+    }
+    return it != atlas.characters.end() ? &it->second : nullptr;
+}
+
+// Screen space rectangle and atlas texture coordinates of one glyph
+struct GlyphQuad
+{
+    float left, bottom, right, top;
+    float uLeft, uRight, vBottom, vTop;
+};
+
+// Lays out the glyph ch with its baseline origin at x, y and advances x to
+// the origin of the next glyph.
+inline GlyphQuad PlaceGlyph(GlyphAtlas const& atlas, Character const& ch,
+                            float& x, float const y, float const scale)
+{
+    float const xpos = x + ch.Bearing.x * scale;
+    float const ypos = y - (static_cast<int>(ch.Size.y) - ch.Bearing.y) * scale;
+    float const w = ch.Size.x * scale;
+    float const h = ch.Size.y * scale;
+
+    // now advance cursors for next glyph (note that advance is
+    // number of 1/64 pixels)
+    x += (ch.Advance.x >> 6) * scale;
+
+    return {xpos,
+            ypos,
+            xpos + w,
+            ypos + h,
+            (float)ch.Offset.x / atlas.width,
+            (float)(ch.Offset.x + ch.Size.x) / atlas.width,
+            (float)ch.Offset.y / atlas.height,
+            0.0f};
+}
+} // namespace impl
+} // namespace glShow
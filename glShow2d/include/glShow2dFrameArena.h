@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace glShow
+{
+namespace impl
+{
+// Bump allocator for data that lives for one frame. Allocations are only
+// released all at once by Reset. When a frame outgrows the arena a new
+// block is chained on, and Reset merges the blocks into one, so after a few
+// frames the workload fits and allocating never touches the heap.
+class FrameArena
+{
+  public:
+    explicit FrameArena(std::size_t const initialCapacity);
+
+    void* Allocate(std::size_t const size, std::size_t const alignment);
+
+    template <typename T>
+    T* AllocateArray(std::size_t const count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    std::string_view Copy(std::string_view const text);
+
+    // True if a block had to be added since the last reset
+    bool Grew() const { return mBlocks.size() > 1; }
+
+    // Invalidates everything allocated since the last reset
+    void Reset();
+
+  private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    void AddBlock(std::size_t const size);
+
+    std::vector<Block> mBlocks;
+    std::size_t mUsed; // bytes used in the last block
+};
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,117 @@
+#pragma once
+
+// clang-format off
+#include <glad/glad.h>
+// clang-format on
+
+#include <array>
+
+namespace glShow
+{
+namespace impl
+{
+// Shadows the bits of GL state glShow2d changes, so that binds which would
+// not change anything are never sent to the driver. Every call that goes
+// through here is counted, giving per frame numbers for API traffic.
+// Assumes it is the only code touching the context.
+class GLStateCache
+{
+  public:
+    struct CallCounts
+    {
+        unsigned program;     // glUseProgram
+        unsigned vertexArray; // glBindVertexArray
+        unsigned buffer;      // glBindBuffer, glBufferData, glMapBufferRange
+        unsigned texture;     // glActiveTexture, glBindTexture, glTexParameter
+        unsigned upload;      // glTexImage2D and friends, glReadPixels
+        unsigned uniform;     // glUniform*
+        unsigned pixelStore;  // glPixelStorei
+        unsigned draw;        // glClear, glDraw*
+        unsigned framebuffer; // glBindFramebuffer, glViewport
+        unsigned blend;       // glBlendFunc
+        unsigned sync;        // glFenceSync, glClientWaitSync, glDeleteSync
+        unsigned elided;      // calls skipped because state was already set
+    };
+
+    GLStateCache();
+
+    void UseProgram(GLuint const program);
+    void BindVertexArray(GLuint const vao);
+    void BindBuffer(GLenum const target, GLuint const buffer);
+    void ActiveTexture(GLenum const unit);
+    void BindTexture2D(GLuint const texture);
+    void PixelStorei(GLenum const pname, GLint const param);
+    void BindFramebuffer(GLuint const framebuffer); // GL_FRAMEBUFFER
+    void Viewport(GLint const x, GLint const y, GLsizei const width,
+                  GLsizei const height);
+    void BlendFunc(GLenum const sfactor, GLenum const dfactor);
+
+    // Deleting a bound object implicitly unbinds it
+    void DeleteProgram(GLuint const program);
+    void DeleteVertexArray(GLuint const vao);
+    void DeleteBuffer(GLuint const buffer);
+    void DeleteTexture(GLuint const texture);
+    void DeleteFramebuffer(GLuint const framebuffer);
+
+    // Calls that are always issued but counted
+    void BufferData(GLenum const target, GLsizeiptr const size,
+                    void const* const data, GLenum const usage);
+    void TexParameteri(GLenum const pname, GLint const param);
+    void TexImage2D(GLint const internalFormat, GLsizei const width,
+                    GLsizei const height, GLenum const format,
+                    void const* const data);
+    void TexSubImage2D(GLint const xoffset, GLint const yoffset,
+                       GLsizei const width, GLsizei const height,
+                       GLenum const format, void const* const data);
+    void CompressedTexImage2D(GLenum const internalFormat, GLsizei const width,
+                              GLsizei const height, GLsizei const imageSize,
+                              void const* const data);
+    void Uniform1i(GLint const location, GLint const v0);
+    void Uniform1f(GLint const location, GLfloat const v0);
+    void Uniform3f(GLint const location, GLfloat const v0, GLfloat const v1,
+                   GLfloat const v2);
+    void UniformMatrix4fv(GLint const location, GLfloat const* const value);
+    void Clear(GLbitfield const mask);
+    void DrawArrays(GLenum const mode, GLint const first, GLsizei const count);
+    void DrawElements(GLenum const mode, GLsizei const count,
+                      GLenum const type);
+    void DrawArraysInstanced(GLenum const mode, GLsizei const count,
+                             GLsizei const instanceCount);
+    // Into the bound GL_PIXEL_PACK_BUFFER at offset data, or into client
+    // memory at data when none is bound
+    void ReadPixels(GLsizei const width, GLsizei const height,
+                    GLenum const format, GLenum const type, void* const data);
+
+    // Map at offset 0
+    void* MapBufferRange(GLenum const target, GLsizeiptr const length,
+                         GLbitfield const access);
+    void UnmapBuffer(GLenum const target);
+    GLsync FenceSync();
+    GLenum ClientWaitSync(GLsync const sync, GLuint64 const timeout);
+    void DeleteSync(GLsync const sync);
+
+    CallCounts const& Counts() const { return mCounts; }
+
+    // Returns the counts since the last call and starts counting anew
+    CallCounts TakeCounts();
+
+  private:
+    static constexpr std::size_t kTextureUnits = 16;
+
+    GLuint mProgram;
+    GLuint mVertexArray;
+    GLuint mArrayBuffer;
+    GLuint mElementBuffer;
+    bool mElementBufferKnown; // element binding is per vao
+    GLenum mActiveTexture;
+    std::array<GLuint, kTextureUnits> mTextures2D;
+    GLint mUnpackAlignment;
+    GLint mPackAlignment;
+    GLuint mFramebuffer;
+    std::array<GLint, 4> mViewport;
+    bool mViewportKnown; // the initial viewport is the window size
+    GLenum mBlendSrc, mBlendDst;
+    CallCounts mCounts;
+};
+} // namespace impl
+} // namespace glShow
@@ -1,16 +1,28 @@
+#pragma once
+
 // clang-format off
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 // clang-format on
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
+#include "glShow2dAllocationCounter.h"
+#include "glShow2dCommon.h"
+#include "glShow2dCompression.h"
+#include "glShow2dFont.h"
+#include "glShow2dFrameArena.h"
+#include "glShow2dGLState.h"
+#include "glShow2dParallel.h"
+#include "glShow2dPixelStats.h"
+#include "glShow2dProgramCache.h"
 
 #include <array>
+#include <cassert>
 #include <chrono>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace glShow
@@ -43,32 +55,80 @@ class glShow2d
     void Draw(unsigned char const* const data, int const width,
               int const height, int const nChannels);
 
-    struct TextColor
-    {
-        float r, g, b;
-    };
+    void DrawCompressed(unsigned char const* const data,
+                        std::size_t const size, int const width,
+                        int const height, BlockFormat const format);
+
+    void EnableUploadCompression(unsigned const nThreads);
+
+    void DisableUploadCompression();
+
+    using TextColor = impl::TextColor;
 
-    void DrawText(std::string const& text, float const x, float const y,
+    void DrawText(std::string_view const text, float const x, float const y,
                   float const scale, TextColor const& color);
 
     void EnableOrReInitTextRenderer(std::string const& pathToFont);
 
+    GLStateCache::CallCounts GetGLCallCounts() const;
+
+    StartupTimings GetStartupTimings() const;
+
+    // Histograms the image texture every frame and reads the results back
+    // through a pair of pixel buffers, collected once their fence has
+    // signalled
+    void EnablePixelStats(bool const overlay);
+
+    void DisablePixelStats();
+
+    // nullptr until the first readback has completed
+    PixelStats const* GetPixelStats() const;
+
+    // Rerenders the last frame into the back buffer and reads it back as rgb
+    bool ReadFrame(unsigned char* const dst, unsigned const width,
+                   unsigned const height);
+
+    // Blocks until window events arrive or timeoutSeconds pass (negative
+    // waits indefinitely), redisplaying the last frame on resize and expose
+    void WaitEvents(double const timeoutSeconds);
+
+    // Wakes WaitEvents, callable from any thread
+    void WakeUp();
+
     ~glShow2d();
 
   private:
-    struct uivec2;
-    struct ivec2;
-    struct vec3;
-    struct Character;
-    struct TextToRender;
+    struct TextDraw;
+
+    static void FramebufferSizeCallback(GLFWwindow* const window,
+                                        int const width, int const height);
+
+    static void WindowRefreshCallback(GLFWwindow* const window);
 
     void LoadTexture(unsigned char const* const data, int const width,
                      int const height, int const nChannels);
 
+    void LoadCompressedTexture(unsigned char const* const data,
+                               int const width, int const height,
+                               BlockFormat const format);
+
+    // Uploads the queued image and text, then displays them
+    void RenderFrame();
+
+    // Draws the last uploaded texture and text batch, nothing is uploaded
+    void RenderResidentFrame();
+
+    void Redisplay();
+
     GLuint CompileShader(char const* const shaderCode, GLenum const shaderType);
 
     GLuint LinkProgram(GLuint const vertexShader, GLuint const fragShader);
 
+    // Loads the program from the binary cache, or compiles, links and
+    // caches it
+    GLuint BuildProgram(char const* const vShaderCode,
+                        char const* const fShaderCode);
+
     void InitGLFWAndGlad();
 
     void LoadTextureVertexArray();
@@ -77,24 +137,82 @@ class glShow2d
 
     void CreateTextShaderProgram();
 
-    void InitTextRenderer(std::string const& pathToFont);
+    void UploadGlyphAtlas(GlyphAtlas atlas);
+
+    // Uploads the vertices of all queued text into mTextVBO
+    void BuildTextBatch();
+
+    void RenderTextBatch();
+
+    void SetTextProjection(GLuint const program);
+
+    void UpdateTextProjections();
+
+    void InitPixelStats();
+
+    void DeletePixelStats();
+
+    // Copies finished readbacks into mPixelStats, oldest first
+    void CollectPixelStats();
+
+    // Scatters the image into the histogram texture and queues its readback
+    void RenderHistogram();
+
+    void RenderPixelStatsOverlay();
 
-    void RenderText(TextToRender const& textStuct);
+    void QueuePixelStatsLabels();
 
     unsigned mWidth;
     unsigned mHeight;
     std::string mWindowName;
     std::unique_ptr<GLFWwindow, detail::DestroyGLFWWindow> mWindow;
-    bool mTextRendererInitialized;
+    bool mTextRendererInitialized{false};
     GLuint mTextureVAO, mTextureVBO, mTextureEBO;
     GLuint mTextureShaderProgram;
     GLuint mImageTexture;
-    std::map<char, Character> mCharacters;
-    GLuint mTextVAO, mTextVBO;
-    GLuint mTextShaderProgram;
-    GLuint mAtlasTexture;
-    GLuint mAtlasWidth, mAtlasHeight;
+    GlyphAtlas mGlyphAtlas;
+    GLuint mTextVAO{0}, mTextVBO{0};
+    GLuint mTextShaderProgram{0};
+    GLint mTextColorLocation;
+    GLuint mAtlasTexture{0};
     std::vector<TextToRender> mTextsToRender;
+    bool mUploadCompression{false};
+    bool mS3TCSupported{false};
+    bool mBPTCSupported{false};
+    WorkerPool mCompressionPool;
+    std::vector<unsigned char> mCompressedImage;
+    GLStateCache mGL;
+    GLStateCache::CallCounts mLastFrameGLCalls{};
+    FrameArena mFrameArena;
+    std::size_t mFrameStartAllocations{0};
+    std::size_t mTextQueueCapacity{0};
+    std::size_t mCompressedImageCapacity{0};
+    ProgramBinaryCache mProgramCache;
+    StartupTimings mStartupTimings{};
+    bool mConstructing{true}; // startup timings are only recorded while true
+    int mImageWidth{0}, mImageHeight{0}, mImageChannels{0};
+    bool mPixelStatsEnabled{false};
+    bool mPixelStatsOverlay{false};
+    bool mPixelStatsReady{false};
+    GLuint mHistogramProgram{0};
+    GLuint mHistogramVAO{0}; // attribute-less, the vertex id picks the texel
+    GLuint mHistogramTexture{0};
+    GLuint mHistogramFramebuffer{0};
+    static constexpr std::size_t kStatsReadbacks = 2;
+    std::array<GLuint, kStatsReadbacks> mStatsBuffers{};
+    std::array<GLsync, kStatsReadbacks> mStatsFences{}; // nullptr when free
+    std::array<unsigned, kStatsReadbacks> mStatsFrames{};
+    std::array<int, kStatsReadbacks> mStatsChannels{};
+    unsigned mFrameNumber{0};
+    PixelStats mPixelStats{};
+    GLuint mOverlayProgram{0};
+    GLint mOverlayChannelsLocation{-1};
+    GLint mOverlayInvPeakLocation{-1};
+    GLuint mOverlayVAO{0}, mOverlayVBO{0};
+    std::vector<TextDraw> mTextDraws; // text batch of the displayed frame
+    bool mHasFrame{false};
+    int mFramebufferWidth, mFramebufferHeight;
+    float mTextSpaceWidth, mTextSpaceHeight; // window size in screen units
 };
 } // namespace impl
 } // namespace glShow
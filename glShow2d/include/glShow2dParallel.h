@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glShow
+{
+namespace impl
+{
+// Threads that are started once and then sleep between jobs, so splitting
+// per frame work neither creates threads nor allocates. The calling thread
+// always takes part, a pool that was never started runs everything inline.
+class WorkerPool
+{
+  public:
+    WorkerPool();
+
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+    ~WorkerPool();
+
+    // nThreads counts the calling thread, 0 uses hardware concurrency.
+    // Restarts the workers if the size changes.
+    void Start(unsigned nThreads);
+
+    void Stop();
+
+    // Threads taking part in ParallelFor, the caller included
+    unsigned Size() const
+    {
+        return static_cast<unsigned>(mWorkers.size()) + 1;
+    }
+
+    // Runs fn(first, last, chunk) over [0, count) split into at most
+    // maxChunks (0 for Size()) contiguous chunks and returns when all are
+    // done. chunk is below Size() and unique per call, for indexing per
+    // thread scratch space. The caller takes chunk 0.
+    template <typename RangeFn>
+    void ParallelFor(int const count, RangeFn const& fn,
+                     unsigned const maxChunks = 0)
+    {
+        unsigned nChunks =
+            maxChunks == 0 ? Size() : std::min(maxChunks, Size());
+        nChunks = std::min(nChunks, static_cast<unsigned>(std::max(count, 0)));
+        if (nChunks <= 1)
+        {
+            if (count > 0)
+            {
+                fn(0, count, 0u);
+            }
+            return;
+        }
+
+        Run(count, nChunks, &fn,
+            [](void const* const job, int const first, int const last,
+               unsigned const chunk) {
+                (*static_cast<RangeFn const*>(job))(first, last, chunk);
+            });
+    }
+
+  private:
+    using JobFn = void (*)(void const* job, int const first, int const last,
+                           unsigned const chunk);
+
+    void Run(int const count, unsigned const nChunks, void const* const job,
+             JobFn const jobFn);
+
+    void RunChunk(unsigned const chunk) const;
+
+    // seen is the generation of the last job before the worker started
+    void WorkerLoop(unsigned const chunk, std::uint64_t seen);
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    std::uint64_t mGeneration; // bumped for every job
+    bool mStopping;
+
+    // current job, written under mMutex
+    void const* mJob;
+    JobFn mJobFn;
+    int mCount;
+    int mChunkSize;
+    unsigned mChunks;
+    unsigned mPending; // worker chunks not yet finished
+};
+} // namespace impl
+} // namespace glShow
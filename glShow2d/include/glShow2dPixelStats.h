@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace glShow
+{
+namespace impl
+{
+// Histogram of one frame with 256 bins per channel and the numbers derived
+// from it. For 8 bit data every value has its own bin, so mean, min, max
+// and the clipped counts are exact as long as the counts are.
+struct PixelStats
+{
+    static constexpr int kBins = 256;
+    static constexpr int kMaxChannels = 4;
+    static constexpr std::uint32_t kGpuCountLimit = 1u << 24;
+
+    int nChannels;
+    std::array<std::array<std::uint32_t, kBins>, kMaxChannels> histogram;
+    std::array<float, kMaxChannels> mean;
+    std::array<unsigned char, kMaxChannels> min;
+    std::array<unsigned char, kMaxChannels> max;
+    std::array<std::uint32_t, kMaxChannels> clippedLow;  // pixels at 0
+    std::array<std::uint32_t, kMaxChannels> clippedHigh; // pixels at 255
+    std::array<bool, kMaxChannels> saturated; // a bin hit kGpuCountLimit
+};
+
+// Fills in everything but the histogram, nChannels and saturated
+void SummarizeHistogram(PixelStats& stats);
+
+// Cpu reference of the gpu histogram pass. data is tightly packed 8 bit
+// data with nChannels (at most kMaxChannels) interleaved channels.
+void ComputePixelStats(unsigned char const* const data, int const width,
+                       int const height, int const nChannels,
+                       PixelStats& stats);
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,51 @@
+#pragma once
+
+// clang-format off
+#include <glad/glad.h>
+// clang-format on
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace glShow
+{
+namespace impl
+{
+// Persists linked programs with glGetProgramBinary so later runs can skip
+// compiling and linking. Binaries only load on the driver that produced
+// them, so entries are keyed by vendor, renderer and version strings as well
+// as the shader sources. All failures fall back to compiling, the cache is
+// best effort.
+class ProgramBinaryCache
+{
+  public:
+    // Disabled cache, Load always misses and Store does nothing
+    ProgramBinaryCache();
+
+    // Needs a current context to query the driver
+    explicit ProgramBinaryCache(std::filesystem::path directory);
+
+    // Only true on 4.1 contexts with at least one binary format, which is
+    // also what glProgramParameteri needs
+    bool Enabled() const { return mEnabled; }
+
+    // Returns a linked program, or 0 if there is no usable binary
+    GLuint Load(char const* const vShaderCode,
+                char const* const fShaderCode) const;
+
+    void Store(GLuint const program, char const* const vShaderCode,
+               char const* const fShaderCode) const;
+
+    static std::filesystem::path DefaultDirectory();
+
+  private:
+    std::filesystem::path PathFor(char const* const vShaderCode,
+                                  char const* const fShaderCode) const;
+
+    bool mEnabled;
+    std::filesystem::path mDirectory;
+    std::string mDriver;
+};
+} // namespace impl
+} // namespace glShow
@@ -0,0 +1,9 @@
+#pragma once
+
+// SSE2 is part of every x64 target. Kernels guarded by GLSHOW2D_SSE2 keep a
+// scalar loop for everything else.
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GLSHOW2D_SSE2
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "glShow2dAllocationCounter.h"
+#include "glShow2dCommon.h"
+#include "glShow2dCompression.h"
+#include "glShow2dFont.h"
+#include "glShow2dFrameArena.h"
+#include "glShow2dGLState.h"
+#include "glShow2dParallel.h"
+#include "glShow2dPixelStats.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace glShow
+{
+namespace impl
+{
+// Cpu backend with the same interface as glShow2d. Frames are composited
+// into a caller owned buffer of width * height * nChannels bytes (3 or 4
+// channels, bottom row first like glReadPixels) and never touch GL.
+class glShow2dSoftware
+{
+  public:
+    // nThreads of 0 uses all hardware threads
+    glShow2dSoftware(unsigned char* const target, unsigned const width,
+                     unsigned const height, int const nChannels,
+                     unsigned const nThreads);
+
+    glShow2dSoftware(unsigned char* const target, unsigned const width,
+                     unsigned const height, int const nChannels,
+                     std::string const& pathToFont, unsigned const nThreads);
+
+    void Draw(unsigned char const* const data, int const width,
+              int const height, int const nChannels);
+
+    void DrawCompressed(unsigned char const* const data,
+                        std::size_t const size, int const width,
+                        int const height, BlockFormat const format);
+
+    // There is no upload to compress, kept for interface parity
+    void EnableUploadCompression(unsigned const) {}
+
+    void DisableUploadCompression() {}
+
+    using TextColor = impl::TextColor;
+
+    void DrawText(std::string_view const text, float const x, float const y,
+                  float const scale, TextColor const& color);
+
+    void EnableOrReInitTextRenderer(std::string const& pathToFont);
+
+    GLStateCache::CallCounts GetGLCallCounts() const { return {}; }
+
+    // Only font rasterization and the total are measured, there is no window
+    // or GL to set up
+    StartupTimings GetStartupTimings() const { return mStartupTimings; }
+
+    // Stats describe the frame just drawn, there is no overlay
+    void EnablePixelStats(bool const) { mPixelStatsEnabled = true; }
+
+    void DisablePixelStats();
+
+    PixelStats const* GetPixelStats() const
+    {
+        return mPixelStatsReady ? &mPixelStats : nullptr;
+    }
+
+    bool ReadFrame(unsigned char* const dst, unsigned const width,
+                   unsigned const height) const;
+
+    // There are no window events, so this only returns on WakeUp or after
+    // timeoutSeconds (negative waits indefinitely). A WakeUp without a
+    // waiter makes the next call return at once, like glfwPostEmptyEvent.
+    void WaitEvents(double const timeoutSeconds);
+
+    // Wakes WaitEvents, callable from any thread
+    void WakeUp();
+
+    ~glShow2dSoftware();
+
+  private:
+    struct PlacedGlyph;
+    struct Tap;
+
+    void CompositeImage(unsigned char const* const data, int const width,
+                        int const height, int const nChannels);
+
+    void CompositeText();
+
+    // Summed capacity of the vectors a frame may grow
+    std::size_t SteadyCapacity() const;
+
+    unsigned char* mTarget;
+    unsigned mWidth;
+    unsigned mHeight;
+    int mChannels;
+    WorkerPool mPool;
+    bool mTextRendererInitialized;
+    GlyphAtlas mGlyphAtlas;
+    std::vector<TextToRender> mTextsToRender;
+    std::vector<PlacedGlyph> mPlacedGlyphs;
+    std::vector<Tap> mColumnTaps;
+    std::vector<unsigned char> mDecompressed;
+    std::vector<float> mTextScratch; // per worker rows for CompositeText
+    FrameArena mFrameArena;
+    std::size_t mFrameStartAllocations;
+    std::size_t mSteadyCapacity;
+    StartupTimings mStartupTimings;
+    bool mPixelStatsEnabled;
+    bool mPixelStatsReady;
+    PixelStats mPixelStats;
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    bool mWokenUp; // guarded by mWakeMutex
+};
+} // namespace impl
+} // namespace glShow
@@ -1,22 +1,56 @@
 #include "glShow2d.h"
 #include "glShow2dImpl.h"
+#include "glShow2dSoftware.h"
+
+#include <variant>
 
 class glShow::glShow2d::glShow2dImpl
 {
   public:
     glShow2dImpl(unsigned const width, unsigned const height,
                  std::string const& windowName)
-        : impl(width, height, windowName)
+        : impl(std::in_place_type<glShow::impl::glShow2d>, width, height,
+               windowName)
     {
     }
 
     glShow2dImpl(unsigned const width, unsigned const height,
                  std::string const& windowName, std::string const& pathToFont)
-        : impl(width, height, windowName, pathToFont)
+        : impl(std::in_place_type<glShow::impl::glShow2d>, width, height,
+               windowName, pathToFont)
+    {
+    }
+
+    glShow2dImpl(unsigned char* const target, unsigned const width,
+                 unsigned const height, int const nChannels,
+                 unsigned const nThreads)
+        : impl(std::in_place_type<glShow::impl::glShow2dSoftware>, target,
+               width, height, nChannels, nThreads)
+    {
+    }
+
+    glShow2dImpl(unsigned char* const target, unsigned const width,
+                 unsigned const height, int const nChannels,
+                 std::string const& pathToFont, unsigned const nThreads)
+        : impl(std::in_place_type<glShow::impl::glShow2dSoftware>, target,
+               width, height, nChannels, pathToFont, nThreads)
+    {
+    }
+
+    // both backends expose the same member functions
+    template <typename Fn>
+    decltype(auto) Visit(Fn&& fn)
+    {
+        return std::visit(std::forward<Fn>(fn), impl);
+    }
+
+    template <typename Fn>
+    decltype(auto) Visit(Fn&& fn) const
     {
+        return std::visit(std::forward<Fn>(fn), impl);
     }
 
-    glShow::impl::glShow2d impl;
+    std::variant<glShow::impl::glShow2d, glShow::impl::glShow2dSoftware> impl;
 };
 
 glShow::glShow2d::glShow2d(unsigned const width, unsigned const height,
@@ -33,22 +67,139 @@ glShow::glShow2d::glShow2d(unsigned const width, unsigned const height,
 {
 }
 
+glShow::glShow2d::glShow2d(unsigned char* const target, unsigned const width,
+                           unsigned const height, int const nChannels,
+                           unsigned const nThreads)
+    : pImpl_(std::make_unique<glShow2dImpl>(target, width, height, nChannels,
+                                            nThreads))
+{
+}
+
+glShow::glShow2d::glShow2d(unsigned char* const target, unsigned const width,
+                           unsigned const height, int const nChannels,
+                           std::string const& pathToFont,
+                           unsigned const nThreads)
+    : pImpl_(std::make_unique<glShow2dImpl>(target, width, height, nChannels,
+                                            pathToFont, nThreads))
+{
+}
+
 glShow::glShow2d::~glShow2d() = default;
 
 void glShow::glShow2d::Draw(unsigned char const* const data, int const width,
                             int const height, int const nChannels)
 {
-    pImpl().impl.Draw(data, width, height, nChannels);
+    pImpl().Visit(
+        [&](auto& impl) { impl.Draw(data, width, height, nChannels); });
+}
+
+void glShow::glShow2d::DrawCompressed(unsigned char const* const data,
+                                      std::size_t const size, int const width,
+                                      int const height,
+                                      CompressedFormat const format)
+{
+    glShow::impl::BlockFormat const blockFormat = [format]() {
+        if (format == CompressedFormat::BC1)
+            return glShow::impl::BlockFormat::BC1;
+        else if (format == CompressedFormat::BC4)
+            return glShow::impl::BlockFormat::BC4;
+        else
+            return glShow::impl::BlockFormat::BC7;
+    }();
+    pImpl().Visit([&](auto& impl) {
+        impl.DrawCompressed(data, size, width, height, blockFormat);
+    });
+}
+
+void glShow::glShow2d::EnableUploadCompression(unsigned const nThreads)
+{
+    pImpl().Visit(
+        [&](auto& impl) { impl.EnableUploadCompression(nThreads); });
+}
+
+void glShow::glShow2d::DisableUploadCompression()
+{
+    pImpl().Visit([](auto& impl) { impl.DisableUploadCompression(); });
 }
 
-void glShow::glShow2d::DrawText(std::string const& text, float const x,
+void glShow::glShow2d::DrawText(std::string_view const text, float const x,
                                 float const y, float const scale,
                                 TextColor const& color)
 {
-    pImpl().impl.DrawText(text, x, y, scale, {color.r, color.g, color.b});
+    pImpl().Visit([&](auto& impl) {
+        impl.DrawText(text, x, y, scale, {color.r, color.g, color.b});
+    });
 }
 
 void glShow::glShow2d::EnableOrReInitTextRenderer(std::string const& pathToFont)
 {
-    pImpl().impl.EnableOrReInitTextRenderer(pathToFont);
+    pImpl().Visit(
+        [&](auto& impl) { impl.EnableOrReInitTextRenderer(pathToFont); });
+}
+
+glShow::glShow2d::GLCallCounts glShow::glShow2d::GetGLCallCounts() const
+{
+    auto const counts =
+        pImpl().Visit([](auto const& impl) { return impl.GetGLCallCounts(); });
+    return {counts.program,    counts.vertexArray, counts.buffer,
+            counts.texture,    counts.upload,      counts.uniform,
+            counts.pixelStore, counts.draw,        counts.framebuffer,
+            counts.blend,      counts.sync,        counts.elided};
+}
+
+void glShow::glShow2d::EnablePixelStats(bool const overlay)
+{
+    pImpl().Visit([&](auto& impl) { impl.EnablePixelStats(overlay); });
+}
+
+void glShow::glShow2d::DisablePixelStats()
+{
+    pImpl().Visit([](auto& impl) { impl.DisablePixelStats(); });
+}
+
+bool glShow::glShow2d::GetPixelStats(PixelStats& stats) const
+{
+    return pImpl().Visit([&stats](auto const& impl) {
+        glShow::impl::PixelStats const* const result = impl.GetPixelStats();
+        if (result == nullptr)
+        {
+            return false;
+        }
+        stats.nChannels = result->nChannels;
+        stats.histogram = result->histogram;
+        stats.mean = result->mean;
+        stats.min = result->min;
+        stats.max = result->max;
+        stats.clippedLow = result->clippedLow;
+        stats.clippedHigh = result->clippedHigh;
+        stats.saturated = result->saturated;
+        return true;
+    });
+}
+
+bool glShow::glShow2d::ReadFrame(unsigned char* const dst,
+                                 unsigned const width, unsigned const height)
+{
+    return pImpl().Visit(
+        [&](auto& impl) { return impl.ReadFrame(dst, width, height); });
+}
+
+void glShow::glShow2d::WaitEvents(double const timeoutSeconds)
+{
+    pImpl().Visit([&](auto& impl) { impl.WaitEvents(timeoutSeconds); });
+}
+
+void glShow::glShow2d::WakeUp()
+{
+    pImpl().Visit([](auto& impl) { impl.WakeUp(); });
+}
+
+glShow::glShow2d::StartupTimings glShow::glShow2d::GetStartupTimings() const
+{
+    return pImpl().Visit([](auto const& impl) -> StartupTimings {
+        auto const t = impl.GetStartupTimings();
+        return {t.window,         t.glLoader,          t.textureSetup,
+                t.shaderPrograms, t.fontRasterization, t.fontWait,
+                t.atlasUpload,    t.total,             t.programsFromCache};
+    });
 }
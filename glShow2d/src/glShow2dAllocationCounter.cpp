@@ -0,0 +1,46 @@
+#include "glShow2dAllocationCounter.h"
+
+#ifdef GLSHOW2D_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local unsigned scopeDepth = 0;
+thread_local std::size_t allocations = 0;
+} // namespace
+
+// The default array and nothrow forms forward to these
+void* operator new(std::size_t size)
+{
+    if (scopeDepth > 0)
+    {
+        ++allocations;
+    }
+    if (size == 0)
+    {
+        size = 1;
+    }
+    if (void* const ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+glShow::impl::AllocationScope::AllocationScope() { ++scopeDepth; }
+
+glShow::impl::AllocationScope::~AllocationScope() { --scopeDepth; }
+
+std::size_t glShow::impl::CountedAllocations() { return allocations; }
+#else
+glShow::impl::AllocationScope::AllocationScope() {}
+
+glShow::impl::AllocationScope::~AllocationScope() {}
+
+std::size_t glShow::impl::CountedAllocations() { return 0; }
+#endif
@@ -0,0 +1,633 @@
+#include "glShow2dCompression.h"
+#include "glShow2dParallel.h"
+#include "glShow2dSimd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+constexpr int kBlockDim = 4;
+constexpr int kBlockPixels = kBlockDim * kBlockDim;
+
+int BlockCount(int const size) { return (size + kBlockDim - 1) / kBlockDim; }
+
+// Only blocks in the last block row or column reach past the image
+bool IsInteriorBlock(int const width, int const height, int const bx,
+                     int const by)
+{
+    return (bx + 1) * kBlockDim <= width && (by + 1) * kBlockDim <= height;
+}
+
+// Copies a 4x4 block of one channel. Reads are clamped at the image edges
+// for edge blocks only.
+void LoadBlockChannel(unsigned char const* const src, int const width,
+                      int const height, int const nChannels, int const channel,
+                      int const bx, int const by,
+                      unsigned char (&out)[kBlockPixels])
+{
+    if (IsInteriorBlock(width, height, bx, by))
+    {
+        for (int y = 0; y < kBlockDim; ++y)
+        {
+            unsigned char const* const row =
+                src + ((static_cast<std::size_t>(by) * kBlockDim + y) * width +
+                       bx * kBlockDim) *
+                          nChannels +
+                channel;
+            if (nChannels == 1)
+            {
+                std::memcpy(out + y * kBlockDim, row, kBlockDim);
+                continue;
+            }
+            for (int x = 0; x < kBlockDim; ++x)
+            {
+                out[y * kBlockDim + x] = row[x * nChannels];
+            }
+        }
+        return;
+    }
+
+    for (int y = 0; y < kBlockDim; ++y)
+    {
+        int const sy = std::min(by * kBlockDim + y, height - 1);
+        for (int x = 0; x < kBlockDim; ++x)
+        {
+            int const sx = std::min(bx * kBlockDim + x, width - 1);
+            out[y * kBlockDim + x] =
+                src[(static_cast<std::size_t>(sy) * width + sx) * nChannels +
+                    channel];
+        }
+    }
+}
+
+// Copies a 4x4 block as interleaved rgba, gray input replicated into rgb
+// and alpha set to 255 when there is none. Interior blocks copy whole rows,
+// reads are clamped at the image edges for edge blocks only.
+void LoadBlockRGBA(unsigned char const* const src, int const width,
+                   int const height, int const nChannels, int const bx,
+                   int const by, unsigned char (&out)[kBlockPixels * 4])
+{
+    if (IsInteriorBlock(width, height, bx, by))
+    {
+        std::size_t const stride = static_cast<std::size_t>(width) * nChannels;
+        unsigned char const* row =
+            src + static_cast<std::size_t>(by) * kBlockDim * stride +
+            static_cast<std::size_t>(bx) * kBlockDim * nChannels;
+        for (int y = 0; y < kBlockDim; ++y, row += stride)
+        {
+            std::uint32_t texels[kBlockDim];
+            if (nChannels == 4)
+            {
+                std::memcpy(texels, row, sizeof(texels));
+            }
+            else if (nChannels == 3)
+            {
+                // four packed rgb texels are 12 bytes, split with shifts
+                std::uint64_t first;
+                std::uint32_t last;
+                std::memcpy(&first, row, sizeof(first));
+                std::memcpy(&last, row + sizeof(first), sizeof(last));
+                texels[0] = static_cast<std::uint32_t>(first);
+                texels[1] = static_cast<std::uint32_t>(first >> 24);
+                texels[2] = static_cast<std::uint32_t>(first >> 48) |
+                            (last << 16);
+                texels[3] = last >> 8;
+                for (std::uint32_t& texel : texels)
+                {
+                    texel |= 0xff000000u;
+                }
+            }
+            else
+            {
+                for (int x = 0; x < kBlockDim; ++x)
+                {
+                    texels[x] = row[x * nChannels] * 0x010101u | 0xff000000u;
+                }
+            }
+            std::memcpy(out + y * kBlockDim * 4, texels, sizeof(texels));
+        }
+        return;
+    }
+
+    for (int y = 0; y < kBlockDim; ++y)
+    {
+        int const sy = std::min(by * kBlockDim + y, height - 1);
+        for (int x = 0; x < kBlockDim; ++x)
+        {
+            int const sx = std::min(bx * kBlockDim + x, width - 1);
+            unsigned char const* const p =
+                src + (static_cast<std::size_t>(sy) * width + sx) * nChannels;
+            unsigned char* const texel = out + (y * kBlockDim + x) * 4;
+            bool const gray = nChannels < 3;
+            texel[0] = p[0];
+            texel[1] = p[gray ? 0 : 1];
+            texel[2] = p[gray ? 0 : 2];
+            texel[3] = nChannels == 4 ? p[3] : 255;
+        }
+    }
+}
+
+std::uint16_t PackRGB565(int const r, int const g, int const b)
+{
+    return static_cast<std::uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) |
+                                      (b >> 3));
+}
+
+void UnpackRGB565(std::uint16_t const c, int (&rgb)[3])
+{
+    int const r = (c >> 11) & 0x1f;
+    int const g = (c >> 5) & 0x3f;
+    int const b = c & 0x1f;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void StoreLE16(unsigned char* const dst, std::uint16_t const v)
+{
+    dst[0] = static_cast<unsigned char>(v & 0xff);
+    dst[1] = static_cast<unsigned char>(v >> 8);
+}
+
+// Endpoints from the inset bounding box, stored max first. Returns false
+// when both endpoints are equal and every index is 0.
+bool StoreBC1Endpoints(int (&minC)[3], int (&maxC)[3], unsigned char* const dst,
+                       int (&palette)[4][3])
+{
+    for (int c = 0; c < 3; ++c)
+    {
+        int const inset = (maxC[c] - minC[c]) >> 4;
+        minC[c] += inset;
+        maxC[c] -= inset;
+    }
+
+    std::uint16_t c0 = PackRGB565(maxC[0], maxC[1], maxC[2]);
+    std::uint16_t c1 = PackRGB565(minC[0], minC[1], minC[2]);
+    if (c0 < c1)
+    {
+        std::swap(c0, c1);
+    }
+    StoreLE16(dst, c0);
+    StoreLE16(dst + 2, c1);
+
+    UnpackRGB565(c0, palette[0]);
+    UnpackRGB565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    return c0 != c1;
+}
+
+void StoreBC1Indices(unsigned char* const dst, std::uint32_t const indices)
+{
+    StoreLE16(dst + 4, static_cast<std::uint16_t>(indices & 0xffff));
+    StoreLE16(dst + 6, static_cast<std::uint16_t>(indices >> 16));
+}
+
+// Bounding box encoders after J.M.P. van Waveren, "Real-Time DXT
+// Compression". The SSE2 and scalar versions produce the same output.
+#ifdef GLSHOW2D_SSE2
+// The BC1 box is inset by 1/16 of its extent. A row of four texels is one
+// register, the squared distance to a palette entry is two madds per row
+// and the nearest entry is picked with compare and select, keeping the
+// first of equal distances like the scalar loop.
+void EncodeBC1Block(unsigned char const (&rgba)[kBlockPixels * 4],
+                    unsigned char* const dst)
+{
+    __m128i rows[kBlockDim];
+    for (int y = 0; y < kBlockDim; ++y)
+    {
+        rows[y] = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(rgba + y * kBlockDim * 4));
+    }
+
+    __m128i lo = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]),
+                              _mm_min_epu8(rows[2], rows[3]));
+    __m128i hi = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]),
+                              _mm_max_epu8(rows[2], rows[3]));
+    lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    lo = _mm_min_epu8(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+    hi = _mm_max_epu8(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    auto const lo32 = static_cast<std::uint32_t>(_mm_cvtsi128_si32(lo));
+    auto const hi32 = static_cast<std::uint32_t>(_mm_cvtsi128_si32(hi));
+    int minC[3], maxC[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        minC[c] = (lo32 >> (8 * c)) & 0xff;
+        maxC[c] = (hi32 >> (8 * c)) & 0xff;
+    }
+
+    int palette[4][3];
+    std::uint32_t indices = 0;
+    if (StoreBC1Endpoints(minC, maxC, dst, palette))
+    {
+        __m128i const zero = _mm_setzero_si128();
+        __m128i const rgbMask = _mm_set1_epi32(0x00ffffff);
+        __m128i const shifts = _mm_set_epi32(64, 16, 4, 1);
+        __m128i entries[4];
+        for (int p = 0; p < 4; ++p)
+        {
+            entries[p] = _mm_set_epi16(
+                0, static_cast<short>(palette[p][2]),
+                static_cast<short>(palette[p][1]),
+                static_cast<short>(palette[p][0]), 0,
+                static_cast<short>(palette[p][2]),
+                static_cast<short>(palette[p][1]),
+                static_cast<short>(palette[p][0]));
+        }
+
+        for (int y = 0; y < kBlockDim; ++y)
+        {
+            __m128i const texels = _mm_and_si128(rows[y], rgbMask);
+            __m128i const texels01 = _mm_unpacklo_epi8(texels, zero);
+            __m128i const texels23 = _mm_unpackhi_epi8(texels, zero);
+
+            __m128i best = _mm_setzero_si128();
+            __m128i bestIndex = _mm_setzero_si128();
+            for (int p = 0; p < 4; ++p)
+            {
+                __m128i const d01 = _mm_sub_epi16(texels01, entries[p]);
+                __m128i const d23 = _mm_sub_epi16(texels23, entries[p]);
+                // {rg, b} partial sums per texel, regrouped to one per lane
+                __m128 const s01 = _mm_castsi128_ps(_mm_madd_epi16(d01, d01));
+                __m128 const s23 = _mm_castsi128_ps(_mm_madd_epi16(d23, d23));
+                __m128i const dist = _mm_add_epi32(
+                    _mm_castps_si128(
+                        _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(2, 0, 2, 0))),
+                    _mm_castps_si128(
+                        _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(3, 1, 3, 1))));
+
+                if (p == 0)
+                {
+                    best = dist;
+                    continue;
+                }
+                __m128i const closer = _mm_cmplt_epi32(dist, best);
+                best = _mm_or_si128(_mm_and_si128(closer, dist),
+                                    _mm_andnot_si128(closer, best));
+                bestIndex = _mm_or_si128(
+                    _mm_and_si128(closer, _mm_set1_epi32(p)),
+                    _mm_andnot_si128(closer, bestIndex));
+            }
+
+            // texel x moves to bits 2x, then the four lanes are or'ed
+            __m128i packed = _mm_mullo_epi16(bestIndex, shifts);
+            packed = _mm_or_si128(
+                packed, _mm_shuffle_epi32(packed, _MM_SHUFFLE(2, 3, 0, 1)));
+            packed = _mm_or_si128(
+                packed, _mm_shuffle_epi32(packed, _MM_SHUFFLE(1, 0, 3, 2)));
+            indices |= static_cast<std::uint32_t>(_mm_cvtsi128_si32(packed))
+                       << (8 * y);
+        }
+    }
+    StoreBC1Indices(dst, indices);
+}
+
+// Endpoints are the exact block extremes, stored max first so the block
+// uses the eight value ramp. The ramp position is the number of the
+// seven thresholds 14 * (max - v) >= (2k - 1) * range that hold, counted
+// with 16 bit compares instead of a division per texel.
+void EncodeBC4Block(unsigned char const (&v)[kBlockPixels],
+                    unsigned char* const dst)
+{
+    __m128i const values =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(v));
+    __m128i lo = _mm_min_epu8(values, _mm_srli_si128(values, 8));
+    __m128i hi = _mm_max_epu8(values, _mm_srli_si128(values, 8));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 2));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 2));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 1));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 1));
+    int const minV = _mm_cvtsi128_si32(lo) & 0xff;
+    int const maxV = _mm_cvtsi128_si32(hi) & 0xff;
+    dst[0] = static_cast<unsigned char>(maxV);
+    dst[1] = static_cast<unsigned char>(minV);
+
+    std::uint64_t indices = 0;
+    int const range = maxV - minV;
+    if (range > 0)
+    {
+        __m128i const zero = _mm_setzero_si128();
+        __m128i const max16 = _mm_set1_epi16(static_cast<short>(maxV));
+        __m128i const fourteen = _mm_set1_epi16(14);
+        __m128i const one = _mm_set1_epi16(1);
+        __m128i const seven = _mm_set1_epi16(7);
+
+        __m128i halves[2] = {_mm_unpacklo_epi8(values, zero),
+                             _mm_unpackhi_epi8(values, zero)};
+        for (__m128i& half : halves)
+        {
+            __m128i const scaled =
+                _mm_mullo_epi16(_mm_sub_epi16(max16, half), fourteen);
+            __m128i pos = zero;
+            for (int k = 1; k <= 7; ++k)
+            {
+                __m128i const threshold =
+                    _mm_set1_epi16(static_cast<short>((2 * k - 1) * range - 1));
+                pos = _mm_sub_epi16(pos, _mm_cmpgt_epi16(scaled, threshold));
+            }
+
+            // 0 stays 0, 7 becomes 1, the rest shift up by one
+            __m128i const isMin = _mm_cmpeq_epi16(pos, seven);
+            __m128i index =
+                _mm_andnot_si128(_mm_cmpeq_epi16(pos, zero),
+                                 _mm_add_epi16(pos, one));
+            half = _mm_or_si128(_mm_andnot_si128(isMin, index),
+                                _mm_and_si128(isMin, one));
+        }
+
+        alignas(16) std::uint16_t index[kBlockPixels];
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), halves[0]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(index + 8), halves[1]);
+        for (int i = 0; i < kBlockPixels; ++i)
+        {
+            indices |= static_cast<std::uint64_t>(index[i]) << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+    {
+        dst[2 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xff);
+    }
+}
+#else
+// The box is inset by 1/16 of its extent to reduce the error contributed by
+// outliers, then every texel picks the nearest of the four palette entries.
+void EncodeBC1Block(unsigned char const (&rgba)[kBlockPixels * 4],
+                    unsigned char* const dst)
+{
+    int minC[3] = {255, 255, 255};
+    int maxC[3] = {0, 0, 0};
+    for (int i = 0; i < kBlockPixels; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            minC[c] = std::min<int>(minC[c], rgba[4 * i + c]);
+            maxC[c] = std::max<int>(maxC[c], rgba[4 * i + c]);
+        }
+    }
+
+    int palette[4][3];
+    std::uint32_t indices = 0;
+    if (StoreBC1Endpoints(minC, maxC, dst, palette))
+    {
+        for (int i = 0; i < kBlockPixels; ++i)
+        {
+            int best = 0;
+            int bestDist = 1 << 30;
+            for (int p = 0; p < 4; ++p)
+            {
+                int const dr = rgba[4 * i + 0] - palette[p][0];
+                int const dg = rgba[4 * i + 1] - palette[p][1];
+                int const db = rgba[4 * i + 2] - palette[p][2];
+                int const dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<std::uint32_t>(best) << (2 * i);
+        }
+    }
+    StoreBC1Indices(dst, indices);
+}
+
+// Endpoints are the exact block extremes, stored max first so the block
+// uses the eight value ramp. Texels are quantized straight onto the ramp
+// instead of searching the palette.
+void EncodeBC4Block(unsigned char const (&v)[kBlockPixels],
+                    unsigned char* const dst)
+{
+    int minV = 255;
+    int maxV = 0;
+    for (int i = 0; i < kBlockPixels; ++i)
+    {
+        minV = std::min<int>(minV, v[i]);
+        maxV = std::max<int>(maxV, v[i]);
+    }
+    dst[0] = static_cast<unsigned char>(maxV);
+    dst[1] = static_cast<unsigned char>(minV);
+
+    std::uint64_t indices = 0;
+    int const range = maxV - minV;
+    if (range > 0)
+    {
+        for (int i = 0; i < kBlockPixels; ++i)
+        {
+            // position on the ramp from max (0) to min (7)
+            int const pos = ((maxV - v[i]) * 14 + range) / (2 * range);
+            int const index = pos == 0 ? 0 : (pos == 7 ? 1 : pos + 1);
+            indices |= static_cast<std::uint64_t>(index) << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+    {
+        dst[2 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xff);
+    }
+}
+#endif
+} // namespace
+
+std::size_t glShow::impl::BlockSize(BlockFormat const format)
+{
+    return format == BlockFormat::BC3 || format == BlockFormat::BC7 ? 16 : 8;
+}
+
+std::size_t glShow::impl::CompressedImageSize(BlockFormat const format,
+                                              int const width,
+                                              int const height)
+{
+    return static_cast<std::size_t>(BlockCount(width)) * BlockCount(height) *
+           BlockSize(format);
+}
+
+void glShow::impl::CompressBC1(unsigned char const* const src, int const width,
+                               int const height, int const nChannels,
+                               unsigned char* const dst, WorkerPool& pool)
+{
+    int const blocksX = BlockCount(width);
+
+    pool.ParallelFor(
+        BlockCount(height), [&](int const first, int const last, unsigned) {
+            unsigned char rgba[kBlockPixels * 4];
+            for (int by = first; by < last; ++by)
+            {
+                for (int bx = 0; bx < blocksX; ++bx)
+                {
+                    LoadBlockRGBA(src, width, height, nChannels, bx, by, rgba);
+                    EncodeBC1Block(
+                        rgba,
+                        dst + (static_cast<std::size_t>(by) * blocksX + bx) *
+                                  8);
+                }
+            }
+        });
+}
+
+void glShow::impl::CompressBC3(unsigned char const* const src, int const width,
+                               int const height, int const nChannels,
+                               unsigned char* const dst, WorkerPool& pool)
+{
+    int const blocksX = BlockCount(width);
+
+    pool.ParallelFor(
+        BlockCount(height), [&](int const first, int const last, unsigned) {
+            unsigned char rgba[kBlockPixels * 4];
+            unsigned char alpha[kBlockPixels];
+            for (int by = first; by < last; ++by)
+            {
+                for (int bx = 0; bx < blocksX; ++bx)
+                {
+                    LoadBlockRGBA(src, width, height, nChannels, bx, by, rgba);
+                    for (int i = 0; i < kBlockPixels; ++i)
+                    {
+                        alpha[i] = rgba[i * 4 + 3];
+                    }
+                    unsigned char* const block =
+                        dst +
+                        (static_cast<std::size_t>(by) * blocksX + bx) * 16;
+                    EncodeBC4Block(alpha, block);
+                    EncodeBC1Block(rgba, block + 8);
+                }
+            }
+        });
+}
+
+void glShow::impl::CompressBC4(unsigned char const* const src, int const width,
+                               int const height, int const nChannels,
+                               unsigned char* const dst, WorkerPool& pool)
+{
+    int const blocksX = BlockCount(width);
+
+    pool.ParallelFor(
+        BlockCount(height), [&](int const first, int const last, unsigned) {
+            unsigned char v[kBlockPixels];
+            for (int by = first; by < last; ++by)
+            {
+                for (int bx = 0; bx < blocksX; ++bx)
+                {
+                    LoadBlockChannel(src, width, height, nChannels, 0, bx, by,
+                                     v);
+                    EncodeBC4Block(
+                        v, dst + (static_cast<std::size_t>(by) * blocksX + bx) *
+                                     8);
+                }
+            }
+        });
+}
+
+void glShow::impl::DecompressBC1(unsigned char const* const src,
+                                 int const width, int const height,
+                                 unsigned char* const dst)
+{
+    int const blocksX = BlockCount(width);
+    for (int by = 0; by < BlockCount(height); ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            unsigned char const* const block =
+                src + (static_cast<std::size_t>(by) * blocksX + bx) * 8;
+            std::uint16_t const c0 =
+                static_cast<std::uint16_t>(block[0] | (block[1] << 8));
+            std::uint16_t const c1 =
+                static_cast<std::uint16_t>(block[2] | (block[3] << 8));
+            std::uint32_t const indices =
+                block[4] | (block[5] << 8) | (block[6] << 16) |
+                (static_cast<std::uint32_t>(block[7]) << 24);
+
+            int palette[4][3];
+            UnpackRGB565(c0, palette[0]);
+            UnpackRGB565(c1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                if (c0 > c1)
+                {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+
+            for (int i = 0; i < kBlockPixels; ++i)
+            {
+                int const x = bx * kBlockDim + i % kBlockDim;
+                int const y = by * kBlockDim + i / kBlockDim;
+                if (x >= width || y >= height)
+                {
+                    continue;
+                }
+                int const index = (indices >> (2 * i)) & 0x3;
+                unsigned char* const out =
+                    dst + (static_cast<std::size_t>(y) * width + x) * 3;
+                out[0] = static_cast<unsigned char>(palette[index][0]);
+                out[1] = static_cast<unsigned char>(palette[index][1]);
+                out[2] = static_cast<unsigned char>(palette[index][2]);
+            }
+        }
+    }
+}
+
+void glShow::impl::DecompressBC4(unsigned char const* const src,
+                                 int const width, int const height,
+                                 unsigned char* const dst)
+{
+    int const blocksX = BlockCount(width);
+    for (int by = 0; by < BlockCount(height); ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            unsigned char const* const block =
+                src + (static_cast<std::size_t>(by) * blocksX + bx) * 8;
+            int const a0 = block[0];
+            int const a1 = block[1];
+            std::uint64_t indices = 0;
+            for (int i = 0; i < 6; ++i)
+            {
+                indices |= static_cast<std::uint64_t>(block[2 + i]) << (8 * i);
+            }
+
+            int palette[8] = {a0, a1};
+            if (a0 > a1)
+            {
+                for (int i = 2; i < 8; ++i)
+                {
+                    palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+                }
+            }
+            else
+            {
+                for (int i = 2; i < 6; ++i)
+                {
+                    palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            for (int i = 0; i < kBlockPixels; ++i)
+            {
+                int const x = bx * kBlockDim + i % kBlockDim;
+                int const y = by * kBlockDim + i / kBlockDim;
+                if (x >= width || y >= height)
+                {
+                    continue;
+                }
+                dst[static_cast<std::size_t>(y) * width + x] =
+                    static_cast<unsigned char>(
+                        palette[(indices >> (3 * i)) & 0x7]);
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "glShow2dFont.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+glShow::impl::GlyphAtlas
+glShow::impl::RasterizeGlyphAtlas(std::string const& pathToFont)
+{
+    GlyphAtlas atlas{0, 0, {}, {}};
+
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft))
+    {
+        std::cout << "ERROR::FREETYPE::COULD_NOT_INIT_FREETYPE_LIBRARY\n";
+        return atlas;
+    }
+
+    FT_Face face;
+    if (FT_New_Face(ft, pathToFont.c_str(), 0, &face))
+    {
+        std::cout << "ERROR::FREETYPE::FAILED_TO_LOAD_FONT\n";
+        FT_Done_FreeType(ft);
+        return atlas;
+    }
+
+    // set size to load glyphs
+    FT_Set_Pixel_Sizes(face, 0, 40);
+
+    // glyphs are rendered once and kept until they are packed, instead of
+    // rendering everything twice to measure the atlas first
+    struct RenderedGlyph
+    {
+        char c;
+        Character ch;
+        std::vector<unsigned char> bitmap;
+    };
+    std::vector<RenderedGlyph> glyphs;
+    glyphs.reserve(128 - 32);
+
+    unsigned totalWidth = 0;
+    unsigned maxHeight = 0;
+    for (unsigned int c = 32; c < 128; ++c)
+    {
+        // load character glyph
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+        {
+            std::cout << "ERROR::FREETYPE::FAILED_TO_LOAD_GLYPH\n";
+            continue;
+        }
+        FT_Bitmap const& bitmap = face->glyph->bitmap;
+
+        RenderedGlyph glyph{
+            static_cast<char>(c),
+            {{bitmap.width, bitmap.rows},
+             {face->glyph->bitmap_left, face->glyph->bitmap_top},
+             {static_cast<int>(face->glyph->advance.x),
+              static_cast<int>(face->glyph->advance.y)},
+             {totalWidth, bitmap.rows}},
+            std::vector<unsigned char>(bitmap.width * bitmap.rows)};
+        for (unsigned row = 0; row < bitmap.rows; ++row)
+        {
+            std::memcpy(glyph.bitmap.data() + row * bitmap.width,
+                        bitmap.buffer + row * bitmap.pitch, bitmap.width);
+        }
+        glyphs.push_back(std::move(glyph));
+
+        // one pixel gap so linear filtering does not bleed between glyphs
+        totalWidth += bitmap.width + 1;
+        maxHeight = std::max(bitmap.rows, maxHeight);
+    }
+
+    // destroy FreeType once we're finished
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    atlas.width = std::max(totalWidth, 1u);
+    atlas.height = std::max(maxHeight, 1u);
+    atlas.pixels.assign(static_cast<std::size_t>(atlas.width) * atlas.height,
+                        0);
+    for (auto const& glyph : glyphs)
+    {
+        for (unsigned row = 0; row < glyph.ch.Size.y; ++row)
+        {
+            std::copy_n(glyph.bitmap.data() + row * glyph.ch.Size.x,
+                        glyph.ch.Size.x,
+                        atlas.pixels.begin() + row * atlas.width +
+                            glyph.ch.Offset.x);
+        }
+        atlas.characters.insert({glyph.c, glyph.ch});
+    }
+
+    return atlas;
+}
@@ -0,0 +1,58 @@
+#include "glShow2dFrameArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+glShow::impl::FrameArena::FrameArena(std::size_t const initialCapacity)
+    : mUsed{0}
+{
+    AddBlock(std::max<std::size_t>(initialCapacity, 1));
+}
+
+void* glShow::impl::FrameArena::Allocate(std::size_t const size,
+                                         std::size_t const alignment)
+{
+    auto const alignUp = [alignment](std::size_t const offset) {
+        return (offset + alignment - 1) / alignment * alignment;
+    };
+
+    std::size_t offset = alignUp(mUsed);
+    if (offset + size > mBlocks.back().size)
+    {
+        AddBlock(std::max(mBlocks.back().size * 2, size + alignment));
+        offset = 0;
+    }
+
+    // new[] storage is aligned for any fundamental type, so offsets within
+    // a block only need aligning relative to its start
+    mUsed = offset + size;
+    return mBlocks.back().data.get() + offset;
+}
+
+std::string_view glShow::impl::FrameArena::Copy(std::string_view const text)
+{
+    char* const copy = AllocateArray<char>(text.size());
+    std::memcpy(copy, text.data(), text.size());
+    return {copy, text.size()};
+}
+
+void glShow::impl::FrameArena::Reset()
+{
+    if (mBlocks.size() > 1)
+    {
+        std::size_t total = 0;
+        for (auto const& block : mBlocks)
+        {
+            total += block.size;
+        }
+        mBlocks.clear();
+        AddBlock(total);
+    }
+    mUsed = 0;
+}
+
+void glShow::impl::FrameArena::AddBlock(std::size_t const size)
+{
+    mBlocks.push_back({std::make_unique<unsigned char[]>(size), size});
+    mUsed = 0;
+}
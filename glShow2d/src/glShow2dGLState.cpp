@@ -0,0 +1,370 @@
+#include "glShow2dGLState.h"
+
+glShow::impl::GLStateCache::GLStateCache()
+    : mProgram{0}, mVertexArray{0}, mArrayBuffer{0}, mElementBuffer{0},
+      mElementBufferKnown{true}, mActiveTexture{GL_TEXTURE0}, mTextures2D{},
+      mUnpackAlignment{4}, mPackAlignment{4}, mFramebuffer{0}, mViewport{},
+      mViewportKnown{false}, mBlendSrc{GL_ONE}, mBlendDst{GL_ZERO}, mCounts{}
+{
+}
+
+void glShow::impl::GLStateCache::UseProgram(GLuint const program)
+{
+    if (program == mProgram)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glUseProgram(program);
+    mProgram = program;
+    ++mCounts.program;
+}
+
+void glShow::impl::GLStateCache::BindVertexArray(GLuint const vao)
+{
+    if (vao == mVertexArray)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glBindVertexArray(vao);
+    mVertexArray = vao;
+    mElementBufferKnown = false;
+    ++mCounts.vertexArray;
+}
+
+void glShow::impl::GLStateCache::BindBuffer(GLenum const target,
+                                            GLuint const buffer)
+{
+    if (target == GL_ARRAY_BUFFER)
+    {
+        if (buffer == mArrayBuffer)
+        {
+            ++mCounts.elided;
+            return;
+        }
+        mArrayBuffer = buffer;
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        if (mElementBufferKnown && buffer == mElementBuffer)
+        {
+            ++mCounts.elided;
+            return;
+        }
+        mElementBuffer = buffer;
+        mElementBufferKnown = true;
+    }
+    glBindBuffer(target, buffer);
+    ++mCounts.buffer;
+}
+
+void glShow::impl::GLStateCache::ActiveTexture(GLenum const unit)
+{
+    if (unit == mActiveTexture)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glActiveTexture(unit);
+    mActiveTexture = unit;
+    ++mCounts.texture;
+}
+
+void glShow::impl::GLStateCache::BindTexture2D(GLuint const texture)
+{
+    std::size_t const unit = mActiveTexture - GL_TEXTURE0;
+    if (unit < kTextureUnits)
+    {
+        if (mTextures2D[unit] == texture)
+        {
+            ++mCounts.elided;
+            return;
+        }
+        mTextures2D[unit] = texture;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    ++mCounts.texture;
+}
+
+void glShow::impl::GLStateCache::PixelStorei(GLenum const pname,
+                                             GLint const param)
+{
+    GLint* const cached = [this, pname]() -> GLint* {
+        if (pname == GL_UNPACK_ALIGNMENT)
+            return &mUnpackAlignment;
+        else if (pname == GL_PACK_ALIGNMENT)
+            return &mPackAlignment;
+        else
+            return nullptr;
+    }();
+
+    if (cached != nullptr)
+    {
+        if (*cached == param)
+        {
+            ++mCounts.elided;
+            return;
+        }
+        *cached = param;
+    }
+    glPixelStorei(pname, param);
+    ++mCounts.pixelStore;
+}
+
+void glShow::impl::GLStateCache::BindFramebuffer(GLuint const framebuffer)
+{
+    if (framebuffer == mFramebuffer)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    mFramebuffer = framebuffer;
+    ++mCounts.framebuffer;
+}
+
+void glShow::impl::GLStateCache::Viewport(GLint const x, GLint const y,
+                                          GLsizei const width,
+                                          GLsizei const height)
+{
+    std::array<GLint, 4> const viewport = {x, y, width, height};
+    if (mViewportKnown && viewport == mViewport)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glViewport(x, y, width, height);
+    mViewport = viewport;
+    mViewportKnown = true;
+    ++mCounts.framebuffer;
+}
+
+void glShow::impl::GLStateCache::BlendFunc(GLenum const sfactor,
+                                           GLenum const dfactor)
+{
+    if (sfactor == mBlendSrc && dfactor == mBlendDst)
+    {
+        ++mCounts.elided;
+        return;
+    }
+    glBlendFunc(sfactor, dfactor);
+    mBlendSrc = sfactor;
+    mBlendDst = dfactor;
+    ++mCounts.blend;
+}
+
+void glShow::impl::GLStateCache::DeleteProgram(GLuint const program)
+{
+    glDeleteProgram(program);
+    if (program != 0 && program == mProgram)
+    {
+        // a program in use is only flagged for deletion, it stays bound
+        UseProgram(0);
+    }
+}
+
+void glShow::impl::GLStateCache::DeleteVertexArray(GLuint const vao)
+{
+    glDeleteVertexArrays(1, &vao);
+    if (vao != 0 && vao == mVertexArray)
+    {
+        mVertexArray = 0;
+        mElementBufferKnown = false;
+    }
+}
+
+void glShow::impl::GLStateCache::DeleteBuffer(GLuint const buffer)
+{
+    glDeleteBuffers(1, &buffer);
+    if (buffer == 0)
+    {
+        return;
+    }
+    if (buffer == mArrayBuffer)
+    {
+        mArrayBuffer = 0;
+    }
+    if (buffer == mElementBuffer)
+    {
+        mElementBuffer = 0;
+    }
+}
+
+void glShow::impl::GLStateCache::DeleteTexture(GLuint const texture)
+{
+    glDeleteTextures(1, &texture);
+    if (texture == 0)
+    {
+        return;
+    }
+    for (auto& bound : mTextures2D)
+    {
+        if (bound == texture)
+        {
+            bound = 0;
+        }
+    }
+}
+
+void glShow::impl::GLStateCache::DeleteFramebuffer(GLuint const framebuffer)
+{
+    glDeleteFramebuffers(1, &framebuffer);
+    if (framebuffer != 0 && framebuffer == mFramebuffer)
+    {
+        mFramebuffer = 0;
+    }
+}
+
+void glShow::impl::GLStateCache::BufferData(GLenum const target,
+                                            GLsizeiptr const size,
+                                            void const* const data,
+                                            GLenum const usage)
+{
+    glBufferData(target, size, data, usage);
+    ++mCounts.buffer;
+}
+
+void glShow::impl::GLStateCache::TexParameteri(GLenum const pname,
+                                               GLint const param)
+{
+    glTexParameteri(GL_TEXTURE_2D, pname, param);
+    ++mCounts.texture;
+}
+
+void glShow::impl::GLStateCache::TexImage2D(GLint const internalFormat,
+                                            GLsizei const width,
+                                            GLsizei const height,
+                                            GLenum const format,
+                                            void const* const data)
+{
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format,
+                 GL_UNSIGNED_BYTE, data);
+    ++mCounts.upload;
+}
+
+void glShow::impl::GLStateCache::TexSubImage2D(
+    GLint const xoffset, GLint const yoffset, GLsizei const width,
+    GLsizei const height, GLenum const format, void const* const data)
+{
+    glTexSubImage2D(GL_TEXTURE_2D, 0, xoffset, yoffset, width, height, format,
+                    GL_UNSIGNED_BYTE, data);
+    ++mCounts.upload;
+}
+
+void glShow::impl::GLStateCache::CompressedTexImage2D(
+    GLenum const internalFormat, GLsizei const width, GLsizei const height,
+    GLsizei const imageSize, void const* const data)
+{
+    glCompressedTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0,
+                           imageSize, data);
+    ++mCounts.upload;
+}
+
+void glShow::impl::GLStateCache::Uniform1i(GLint const location,
+                                           GLint const v0)
+{
+    glUniform1i(location, v0);
+    ++mCounts.uniform;
+}
+
+void glShow::impl::GLStateCache::Uniform1f(GLint const location,
+                                           GLfloat const v0)
+{
+    glUniform1f(location, v0);
+    ++mCounts.uniform;
+}
+
+void glShow::impl::GLStateCache::Uniform3f(GLint const location,
+                                           GLfloat const v0, GLfloat const v1,
+                                           GLfloat const v2)
+{
+    glUniform3f(location, v0, v1, v2);
+    ++mCounts.uniform;
+}
+
+void glShow::impl::GLStateCache::UniformMatrix4fv(GLint const location,
+                                                  GLfloat const* const value)
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, value);
+    ++mCounts.uniform;
+}
+
+void glShow::impl::GLStateCache::Clear(GLbitfield const mask)
+{
+    glClear(mask);
+    ++mCounts.draw;
+}
+
+void glShow::impl::GLStateCache::DrawArrays(GLenum const mode,
+                                            GLint const first,
+                                            GLsizei const count)
+{
+    glDrawArrays(mode, first, count);
+    ++mCounts.draw;
+}
+
+void glShow::impl::GLStateCache::DrawElements(GLenum const mode,
+                                              GLsizei const count,
+                                              GLenum const type)
+{
+    glDrawElements(mode, count, type, 0);
+    ++mCounts.draw;
+}
+
+void glShow::impl::GLStateCache::DrawArraysInstanced(
+    GLenum const mode, GLsizei const count, GLsizei const instanceCount)
+{
+    glDrawArraysInstanced(mode, 0, count, instanceCount);
+    ++mCounts.draw;
+}
+
+void glShow::impl::GLStateCache::ReadPixels(GLsizei const width,
+                                            GLsizei const height,
+                                            GLenum const format,
+                                            GLenum const type,
+                                            void* const data)
+{
+    glReadPixels(0, 0, width, height, format, type, data);
+    ++mCounts.upload;
+}
+
+void* glShow::impl::GLStateCache::MapBufferRange(GLenum const target,
+                                                 GLsizeiptr const length,
+                                                 GLbitfield const access)
+{
+    ++mCounts.buffer;
+    return glMapBufferRange(target, 0, length, access);
+}
+
+void glShow::impl::GLStateCache::UnmapBuffer(GLenum const target)
+{
+    glUnmapBuffer(target);
+    ++mCounts.buffer;
+}
+
+GLsync glShow::impl::GLStateCache::FenceSync()
+{
+    ++mCounts.sync;
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLenum glShow::impl::GLStateCache::ClientWaitSync(GLsync const sync,
+                                                  GLuint64 const timeout)
+{
+    ++mCounts.sync;
+    return glClientWaitSync(sync, 0, timeout);
+}
+
+void glShow::impl::GLStateCache::DeleteSync(GLsync const sync)
+{
+    glDeleteSync(sync);
+    ++mCounts.sync;
+}
+
+glShow::impl::GLStateCache::CallCounts glShow::impl::GLStateCache::TakeCounts()
+{
+    CallCounts const counts = mCounts;
+    mCounts = CallCounts{};
+    return counts;
+}
@@ -1,10 +1,59 @@
 #include "glShow2dImpl.h"
 
+#include <cstdio>
+#include <cstring>
+
+// S3TC is an extension in the core profile glad is generated for
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
 namespace
 {
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+// Room for the queued text and its vertices of a typical frame
+constexpr std::size_t kFrameArenaSize = 64 * 1024;
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<float, std::milli>;
+
+// Histogram overlay in text coordinates, bottom left corner
+constexpr float kOverlayLeft = 10.0f;
+constexpr float kOverlayBottom = 10.0f;
+constexpr float kOverlayWidth = 256.0f;
+constexpr float kOverlayHeight = 100.0f;
+constexpr float kOverlayTextScale = 0.35f;
+constexpr float kOverlayLineHeight = 16.0f;
+
+bool HasExtension(char const* const name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        char const* const extension = reinterpret_cast<char const*>(
+            glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension != nullptr && std::strcmp(extension, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Fn>
+float MeasureMilliseconds(Fn const& fn)
 {
-    glViewport(0, 0, width, height);
+    auto const start = Clock::now();
+    fn();
+    return Milliseconds(Clock::now() - start).count();
 }
 
 constexpr char* GetTextureVertexShader()
@@ -77,81 +126,176 @@ constexpr char* GetTextFragShader()
         }
         )";
 }
-} // namespace
 
-struct glShow::impl::glShow2d::uivec2
+// One point per texel and channel, drawn with additive blending into a
+// 256 x 4 float target: the value picks the column, the channel the row
+constexpr char const* GetHistogramVertexShader()
 {
-    unsigned x, y;
-};
+    return R"(
+        #version 330 core
+        uniform sampler2D image;
 
-struct glShow::impl::glShow2d::ivec2
-{
-    int x, y;
-};
+        void main()
+        {
+            ivec2 size = textureSize(image, 0);
+            ivec2 texel = ivec2(gl_VertexID % size.x, gl_VertexID / size.x);
+            float value = texelFetch(image, texel, 0)[gl_InstanceID];
+            float bin = floor(value * 255.0 + 0.5);
+
+            gl_Position = vec4((bin + 0.5) / 128.0 - 1.0,
+                               (float(gl_InstanceID) + 0.5) / 2.0 - 1.0,
+                               0.0, 1.0);
+        }
+        )";
+}
 
-struct glShow::impl::glShow2d::vec3
+constexpr char const* GetHistogramFragShader()
 {
-    float r, g, b;
-};
+    return R"(
+        #version 330 core
+        out vec4 count;
 
-struct glShow::impl::glShow2d::Character
+        void main()
+        {
+            count = vec4(1.0);
+        }
+        )";
+}
+
+// Drawn with the text vertex shader over a quad in text coordinates
+constexpr char const* GetOverlayFragShader()
 {
-    uivec2 Size;   // Size of glyph
-    ivec2 Bearing; // Offset from baseline to left/top of glyph
-    ivec2 Advance; // Offset to advance to next glyph
-    uivec2 Offset; // Offset to char in tex atlas in range [0.0, 1.0]
-};
+    return R"(
+        #version 330 core
+        in vec2 oTexCoords;
+        out vec4 color;
 
-struct glShow::impl::glShow2d::TextToRender
+        uniform sampler2D histogram;
+        uniform int channels;
+        uniform float invPeak;
+
+        void main()
+        {
+            int bin = min(int(oTexCoords.x * 256.0), 255);
+            vec3 bars = vec3(0.0);
+            for (int c = 0; c < channels; ++c)
+            {
+                float height = texelFetch(histogram, ivec2(bin, c), 0).r;
+                if (oTexCoords.y < height * invPeak)
+                {
+                    bars += channels == 1 || c == 3
+                                ? vec3(0.6)
+                                : vec3(equal(ivec3(c), ivec3(0, 1, 2)));
+                }
+            }
+
+            color = bars == vec3(0.0) ? vec4(0.0, 0.0, 0.0, 0.5)
+                                      : vec4(min(bars, 1.0), 0.9);
+        }
+        )";
+}
+} // namespace
+
+// Glyphs of one DrawText call in the resident text vertex buffer
+struct glShow::impl::glShow2d::TextDraw
 {
-    std::string text;
-    float x, y;
-    float scale;
-    vec3 color;
+    GLint first;
+    GLsizei count;
+    TextColor color;
 };
 
 glShow::impl::glShow2d::glShow2d(unsigned const width, unsigned const height,
                                  std::string const& windowName)
     : mWidth{width}, mHeight{height}, mWindowName{windowName},
-      mTextRendererInitialized{false}
+      mFrameArena{kFrameArenaSize}, mFramebufferWidth{static_cast<int>(width)},
+      mFramebufferHeight{static_cast<int>(height)},
+      mTextSpaceWidth{static_cast<float>(width)},
+      mTextSpaceHeight{static_cast<float>(height)}
 {
+    auto const start = Clock::now();
+
     InitGLFWAndGlad();
 
-    LoadTextureVertexArray();
+    mStartupTimings.textureSetup =
+        MeasureMilliseconds([this]() { LoadTextureVertexArray(); });
     CreateTextureShaderProgram();
+
+    mStartupTimings.total = Milliseconds(Clock::now() - start).count();
+    mConstructing = false;
 }
 
 glShow::impl::glShow2d::glShow2d(unsigned const width, unsigned const height,
                                  std::string const& windowName,
                                  std::string const& pathToFont)
     : mWidth{width}, mHeight{height}, mWindowName{windowName},
-      mTextRendererInitialized{true}
+      mFrameArena{kFrameArenaSize}, mFramebufferWidth{static_cast<int>(width)},
+      mFramebufferHeight{static_cast<int>(height)},
+      mTextSpaceWidth{static_cast<float>(width)},
+      mTextSpaceHeight{static_cast<float>(height)}
 {
+    auto const start = Clock::now();
+
+    // FreeType needs no context, so rasterize the glyphs on a worker while
+    // this thread creates the window and the programs
+    std::future<GlyphAtlas> font =
+        std::async(std::launch::async, [this, pathToFont]() {
+            auto const fontStart = Clock::now();
+            GlyphAtlas atlas = RasterizeGlyphAtlas(pathToFont);
+            mStartupTimings.fontRasterization =
+                Milliseconds(Clock::now() - fontStart).count();
+            return atlas;
+        });
+
     InitGLFWAndGlad();
 
-    LoadTextureVertexArray();
+    mStartupTimings.textureSetup =
+        MeasureMilliseconds([this]() { LoadTextureVertexArray(); });
     CreateTextureShaderProgram();
-
-    InitTextRenderer(pathToFont);
     CreateTextShaderProgram();
+
+    GlyphAtlas atlas;
+    mStartupTimings.fontWait =
+        MeasureMilliseconds([&atlas, &font]() { atlas = font.get(); });
+    mStartupTimings.atlasUpload = MeasureMilliseconds(
+        [this, &atlas]() { UploadGlyphAtlas(std::move(atlas)); });
+
+    mStartupTimings.total = Milliseconds(Clock::now() - start).count();
+    mConstructing = false;
 }
 
 void glShow::impl::glShow2d::EnableOrReInitTextRenderer(
     std::string const& pathToFont)
 {
-    InitTextRenderer(pathToFont);
+    UploadGlyphAtlas(RasterizeGlyphAtlas(pathToFont));
+    if (mTextShaderProgram == 0)
+    {
+        CreateTextShaderProgram();
+    }
+}
+
+glShow::impl::StartupTimings
+glShow::impl::glShow2d::GetStartupTimings() const
+{
+    return mStartupTimings;
 }
 
 glShow::impl::glShow2d::~glShow2d()
 {
-    glDeleteVertexArrays(1, &mTextureVAO);
-    glDeleteBuffers(1, &mTextureVBO);
-    glDeleteBuffers(1, &mTextureEBO);
+    mCompressionPool.Stop();
+
+    mGL.DeleteVertexArray(mTextureVAO);
+    mGL.DeleteBuffer(mTextureVBO);
+    mGL.DeleteBuffer(mTextureEBO);
+    mGL.DeleteProgram(mTextureShaderProgram);
 
-    glDeleteVertexArrays(1, &mTextVAO);
-    glDeleteBuffers(1, &mTextVBO);
+    mGL.DeleteVertexArray(mTextVAO);
+    mGL.DeleteBuffer(mTextVBO);
+    mGL.DeleteTexture(mAtlasTexture);
+    mGL.DeleteProgram(mTextShaderProgram);
 
-    glDeleteTextures(1, &mImageTexture);
+    mGL.DeleteTexture(mImageTexture);
+
+    DeletePixelStats();
 
     glfwTerminate();
 }
@@ -160,47 +304,273 @@ void glShow::impl::glShow2d::Draw(unsigned char const* const data,
                                   int const width, int const height,
                                   int const nChannels)
 {
+    AllocationScope const allocationScope;
     if (!glfwWindowShouldClose(mWindow.get()))
     {
-        LoadTexture(data, width, height, nChannels);
+        // without S3TC only single channel images are compressed
+        if (mUploadCompression &&
+            (nChannels == 1 ||
+             (mS3TCSupported && (nChannels == 3 || nChannels == 4))))
+        {
+            // BC1 has no alpha, rgba keeps it in a BC3 alpha block
+            BlockFormat const format = nChannels == 1   ? BlockFormat::BC4
+                                       : nChannels == 3 ? BlockFormat::BC1
+                                                        : BlockFormat::BC3;
+            std::size_t const size =
+                CompressedImageSize(format, width, height);
+            mCompressedImage.resize(size);
+            if (format == BlockFormat::BC4)
+            {
+                CompressBC4(data, width, height, nChannels,
+                            mCompressedImage.data(), mCompressionPool);
+            }
+            else if (format == BlockFormat::BC1)
+            {
+                CompressBC1(data, width, height, nChannels,
+                            mCompressedImage.data(), mCompressionPool);
+            }
+            else
+            {
+                CompressBC3(data, width, height, nChannels,
+                            mCompressedImage.data(), mCompressionPool);
+            }
+            LoadCompressedTexture(mCompressedImage.data(), width, height,
+                                  format);
+        }
+        else
+        {
+            LoadTexture(data, width, height, nChannels);
+        }
 
-        glClear(GL_COLOR_BUFFER_BIT);
+        RenderFrame();
+    }
+    else
+    {
+        throw WindowClosedError();
+    }
+}
 
-        glUseProgram(mTextureShaderProgram);
+void glShow::impl::glShow2d::DrawCompressed(unsigned char const* const data,
+                                            std::size_t const size,
+                                            int const width, int const height,
+                                            BlockFormat const format)
+{
+    AllocationScope const allocationScope;
+    if (!glfwWindowShouldClose(mWindow.get()))
+    {
+        if (size < CompressedImageSize(format, width, height))
+        {
+            std::cout << "Compressed image data too small\n";
+            return;
+        }
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, mImageTexture);
+        if (format == BlockFormat::BC1 && !mS3TCSupported)
+        {
+            // the encoder output is not needed here, decode into it
+            mCompressedImage.resize(static_cast<std::size_t>(width) * height *
+                                    3);
+            DecompressBC1(data, width, height, mCompressedImage.data());
+            LoadTexture(mCompressedImage.data(), width, height, 3);
+        }
+        else if (format == BlockFormat::BC7 && !mBPTCSupported)
+        {
+            std::cout << "BC7 is not supported by this OpenGL context\n";
+            return;
+        }
+        else
+        {
+            LoadCompressedTexture(data, width, height, format);
+        }
 
-        glBindVertexArray(mTextureVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        RenderFrame();
+    }
+    else
+    {
+        throw WindowClosedError();
+    }
+}
+
+void glShow::impl::glShow2d::EnableUploadCompression(unsigned const nThreads)
+{
+    if (!mS3TCSupported)
+    {
+        std::cout << "S3TC is not supported by this OpenGL context, only "
+                     "single channel images are compressed\n";
+    }
+    mUploadCompression = true;
+    mCompressionPool.Start(nThreads);
+}
 
-        for (auto const& text : mTextsToRender)
+void glShow::impl::glShow2d::DisableUploadCompression()
+{
+    mUploadCompression = false;
+    mCompressionPool.Stop();
+    mCompressedImage.clear();
+    mCompressedImage.shrink_to_fit();
+}
+
+void glShow::impl::glShow2d::RenderFrame()
+{
+    if (mPixelStatsEnabled)
+    {
+        CollectPixelStats();
+        RenderHistogram();
+        if (mPixelStatsOverlay)
         {
-            RenderText(text);
+            QueuePixelStatsLabels();
         }
-        mTextsToRender.clear();
+    }
 
-        glfwSwapBuffers(mWindow.get());
-        glfwPollEvents();
+    BuildTextBatch();
+    mTextsToRender.clear();
+    mHasFrame = true;
+
+    RenderResidentFrame();
+    glfwSwapBuffers(mWindow.get());
+    mLastFrameGLCalls = mGL.TakeCounts();
+    ++mFrameNumber;
+
+    // may redisplay the frame above if the window was resized or exposed
+    glfwPollEvents();
+
+    // Once the arena, the text queue and the compressed image have grown to
+    // fit the workload, a frame must not touch the heap
+    bool const steadyState =
+        !mFrameArena.Grew() &&
+        mTextsToRender.capacity() == mTextQueueCapacity &&
+        mCompressedImage.capacity() == mCompressedImageCapacity;
+    assert(!steadyState || CountedAllocations() == mFrameStartAllocations);
+    (void)steadyState;
+
+    mFrameArena.Reset();
+    mTextQueueCapacity = mTextsToRender.capacity();
+    mCompressedImageCapacity = mCompressedImage.capacity();
+    mFrameStartAllocations = CountedAllocations();
+}
+
+void glShow::impl::glShow2d::RenderResidentFrame()
+{
+    // elided unless the histogram pass or a resize changed them
+    mGL.BindFramebuffer(0);
+    mGL.Viewport(0, 0, mFramebufferWidth, mFramebufferHeight);
+    mGL.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    mGL.Clear(GL_COLOR_BUFFER_BIT);
+    if (!mHasFrame)
+    {
+        return;
+    }
+
+    mGL.UseProgram(mTextureShaderProgram);
+
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mImageTexture);
+
+    mGL.BindVertexArray(mTextureVAO);
+    mGL.DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT);
+
+    if (mPixelStatsEnabled && mPixelStatsOverlay)
+    {
+        RenderPixelStatsOverlay();
+    }
+
+    RenderTextBatch();
+}
+
+void glShow::impl::glShow2d::Redisplay()
+{
+    RenderResidentFrame();
+    glfwSwapBuffers(mWindow.get());
+}
+
+bool glShow::impl::glShow2d::ReadFrame(unsigned char* const dst,
+                                       unsigned const width,
+                                       unsigned const height)
+{
+    if (width > static_cast<unsigned>(mFramebufferWidth) ||
+        height > static_cast<unsigned>(mFramebufferHeight))
+    {
+        return false;
+    }
+
+    // the back buffer is undefined after a swap, so draw the frame again
+    RenderResidentFrame();
+    mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    mGL.PixelStorei(GL_PACK_ALIGNMENT, 1);
+    mGL.ReadPixels(static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                   GL_RGB, GL_UNSIGNED_BYTE, dst);
+    return true;
+}
+
+void glShow::impl::glShow2d::WaitEvents(double const timeoutSeconds)
+{
+    if (glfwWindowShouldClose(mWindow.get()))
+    {
+        throw WindowClosedError();
+    }
+
+    // resize and refresh callbacks redisplay the resident frame from in here
+    if (timeoutSeconds < 0.0)
+    {
+        glfwWaitEvents();
     }
     else
+    {
+        glfwWaitEventsTimeout(timeoutSeconds);
+    }
+
+    if (glfwWindowShouldClose(mWindow.get()))
     {
         throw WindowClosedError();
     }
 }
 
-void glShow::impl::glShow2d::DrawText(std::string const& text, float const x,
-                                      float const y, float const scale,
+void glShow::impl::glShow2d::WakeUp() { glfwPostEmptyEvent(); }
+
+void glShow::impl::glShow2d::FramebufferSizeCallback(GLFWwindow* const window,
+                                                     int const width,
+                                                     int const height)
+{
+    auto& self = *static_cast<glShow2d*>(glfwGetWindowUserPointer(window));
+    self.mFramebufferWidth = width;
+    self.mFramebufferHeight = height;
+
+    // text stays at its pixel size instead of stretching with the window
+    int windowWidth, windowHeight;
+    glfwGetWindowSize(window, &windowWidth, &windowHeight);
+    if (windowWidth > 0 && windowHeight > 0)
+    {
+        self.mTextSpaceWidth = static_cast<float>(windowWidth);
+        self.mTextSpaceHeight = static_cast<float>(windowHeight);
+        self.UpdateTextProjections();
+    }
+
+    self.Redisplay();
+}
+
+void glShow::impl::glShow2d::WindowRefreshCallback(GLFWwindow* const window)
+{
+    static_cast<glShow2d*>(glfwGetWindowUserPointer(window))->Redisplay();
+}
+
+glShow::impl::GLStateCache::CallCounts
+glShow::impl::glShow2d::GetGLCallCounts() const
+{
+    return mLastFrameGLCalls;
+}
+
+void glShow::impl::glShow2d::DrawText(std::string_view const text,
+                                      float const x, float const y,
+                                      float const scale,
                                       TextColor const& color)
 {
+    AllocationScope const allocationScope;
     if (!mTextRendererInitialized)
     {
         std::cout << "Text renderer not initialized\n";
     }
     else
     {
-        mTextsToRender.push_back(
-            {text, x, y, scale, vec3{color.r, color.g, color.b}});
+        mTextsToRender.push_back({mFrameArena.Copy(text), x, y, scale, color});
     }
 }
 
@@ -208,13 +578,10 @@ void glShow::impl::glShow2d::LoadTexture(unsigned char const* const data,
                                          int const width, int const height,
                                          int const nChannels)
 {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mImageTexture);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mImageTexture);
+    // rows of 1 and 3 channel images are not 4 byte aligned
+    mGL.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     GLenum const format = [nChannels]() {
         if (nChannels == 1)
@@ -227,9 +594,41 @@ void glShow::impl::glShow2d::LoadTexture(unsigned char const* const data,
             return GL_FALSE;
     }();
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,
-                 GL_UNSIGNED_BYTE, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    mGL.TexImage2D(format, width, height, format, data);
+
+    mImageWidth = width;
+    mImageHeight = height;
+    mImageChannels = nChannels;
+}
+
+void glShow::impl::glShow2d::LoadCompressedTexture(
+    unsigned char const* const data, int const width, int const height,
+    BlockFormat const format)
+{
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mImageTexture);
+
+    GLenum const internalFormat = [format]() {
+        if (format == BlockFormat::BC1)
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        else if (format == BlockFormat::BC3)
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        else if (format == BlockFormat::BC4)
+            return GL_COMPRESSED_RED_RGTC1;
+        else
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }();
+
+    mGL.CompressedTexImage2D(
+        internalFormat, width, height,
+        static_cast<GLsizei>(CompressedImageSize(format, width, height)),
+        data);
+
+    mImageWidth = width;
+    mImageHeight = height;
+    mImageChannels = format == BlockFormat::BC1   ? 3
+                     : format == BlockFormat::BC4 ? 1
+                                                  : 4;
 }
 
 GLuint glShow::impl::glShow2d::CompileShader(char const* const shaderCode,
@@ -270,12 +669,49 @@ GLuint glShow::impl::glShow2d::CompileShader(char const* const shaderCode,
     return shader;
 }
 
+GLuint glShow::impl::glShow2d::BuildProgram(char const* const vShaderCode,
+                                            char const* const fShaderCode)
+{
+    auto const start = Clock::now();
+
+    GLuint program = mProgramCache.Load(vShaderCode, fShaderCode);
+    bool const fromCache = program != 0;
+    if (!fromCache)
+    {
+        GLuint const vertexShader =
+            CompileShader(vShaderCode, GL_VERTEX_SHADER);
+        GLuint const fragShader =
+            CompileShader(fShaderCode, GL_FRAGMENT_SHADER);
+
+        program = LinkProgram(vertexShader, fragShader);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragShader);
+
+        mProgramCache.Store(program, vShaderCode, fShaderCode);
+    }
+
+    // programs built later, e.g. for pixel stats, are not part of startup
+    if (mConstructing)
+    {
+        mStartupTimings.shaderPrograms +=
+            Milliseconds(Clock::now() - start).count();
+        mStartupTimings.programsFromCache += fromCache ? 1 : 0;
+    }
+    return program;
+}
+
 GLuint glShow::impl::glShow2d::LinkProgram(GLuint const vertexShader,
                                            GLuint const fragShader)
 {
     GLuint const shaderProgram = glCreateProgram();
     glAttachShader(shaderProgram, vertexShader);
     glAttachShader(shaderProgram, fragShader);
+    if (mProgramCache.Enabled())
+    {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    }
     glLinkProgram(shaderProgram);
 
     GLint success;
@@ -295,6 +731,8 @@ GLuint glShow::impl::glShow2d::LinkProgram(GLuint const vertexShader,
 
 void glShow::impl::glShow2d::InitGLFWAndGlad()
 {
+    auto const start = Clock::now();
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -308,16 +746,41 @@ void glShow::impl::glShow2d::InitGLFWAndGlad()
         glfwTerminate();
     }
     glfwMakeContextCurrent(mWindow.get());
-    glfwSetFramebufferSizeCallback(mWindow.get(), framebuffer_size_callback);
+    glfwSetWindowUserPointer(mWindow.get(), this);
+    glfwSetFramebufferSizeCallback(mWindow.get(), FramebufferSizeCallback);
+    glfwSetWindowRefreshCallback(mWindow.get(), WindowRefreshCallback);
+    glfwGetFramebufferSize(mWindow.get(), &mFramebufferWidth,
+                           &mFramebufferHeight);
+    int windowWidth, windowHeight;
+    glfwGetWindowSize(mWindow.get(), &windowWidth, &windowHeight);
+    if (windowWidth > 0 && windowHeight > 0)
+    {
+        mTextSpaceWidth = static_cast<float>(windowWidth);
+        mTextSpaceHeight = static_cast<float>(windowHeight);
+    }
     glfwSetInputMode(mWindow.get(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 
+    auto const windowCreated = Clock::now();
+    mStartupTimings.window = Milliseconds(windowCreated - start).count();
+
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
         std::cout << "Failed to initialize glad\n";
     }
     glfwSwapInterval(0);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    mGL.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // RGTC (BC4) is core since 3.0, S3TC and before 4.2 BPTC are extensions
+    mS3TCSupported = HasExtension("GL_EXT_texture_compression_s3tc");
+    mBPTCSupported = GLAD_GL_VERSION_4_2 ||
+                     HasExtension("GL_ARB_texture_compression_bptc");
+
+    mProgramCache =
+        ProgramBinaryCache(ProgramBinaryCache::DefaultDirectory());
+
+    mStartupTimings.glLoader =
+        Milliseconds(Clock::now() - windowCreated).count();
 }
 
 void glShow::impl::glShow2d::LoadTextureVertexArray()
@@ -343,15 +806,15 @@ void glShow::impl::glShow2d::LoadTextureVertexArray()
 
     using VertexType = decltype(vertices)::value_type;
 
-    glBindVertexArray(mTextureVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, mTextureVBO);
-    glBufferData(GL_ARRAY_BUFFER, std::size(vertices) * sizeof(VertexType),
-                 vertices.data(), GL_STATIC_DRAW);
+    mGL.BindVertexArray(mTextureVAO);
+    mGL.BindBuffer(GL_ARRAY_BUFFER, mTextureVBO);
+    mGL.BufferData(GL_ARRAY_BUFFER, std::size(vertices) * sizeof(VertexType),
+                   vertices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mTextureEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 std::size(indices) * sizeof(decltype(indices)::value_type),
-                 indices.data(), GL_STATIC_DRAW);
+    mGL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mTextureEBO);
+    mGL.BufferData(GL_ELEMENT_ARRAY_BUFFER,
+                   std::size(indices) * sizeof(decltype(indices)::value_type),
+                   indices.data(), GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(VertexType),
                           (void*)0);
@@ -361,10 +824,15 @@ void glShow::impl::glShow2d::LoadTextureVertexArray()
                           (void*)(2 * sizeof(VertexType)));
     glEnableVertexAttribArray(1);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
     glGenTextures(1, &mImageTexture);
+
+    // sampling parameters are texture state, set them once up front
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mImageTexture);
+    mGL.TexParameteri(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    mGL.TexParameteri(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    mGL.TexParameteri(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    mGL.TexParameteri(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 }
 
 void glShow::impl::glShow2d::CreateTextureShaderProgram()
@@ -372,16 +840,10 @@ void glShow::impl::glShow2d::CreateTextureShaderProgram()
     constexpr char* vShaderCode = GetTextureVertexShader();
     constexpr char* fShaderCode = GetTextureFragShader();
 
-    GLuint const vertexShader = CompileShader(vShaderCode, GL_VERTEX_SHADER);
-    GLuint const fragShader = CompileShader(fShaderCode, GL_FRAGMENT_SHADER);
-
-    mTextureShaderProgram = LinkProgram(vertexShader, fragShader);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragShader);
+    mTextureShaderProgram = BuildProgram(vShaderCode, fShaderCode);
 
-    glUseProgram(mTextureShaderProgram);
-    glUniform1i(glGetUniformLocation(mTextureShaderProgram, "tex"), 0);
+    mGL.UseProgram(mTextureShaderProgram);
+    mGL.Uniform1i(glGetUniformLocation(mTextureShaderProgram, "tex"), 0);
 }
 
 void glShow::impl::glShow2d::CreateTextShaderProgram()
@@ -389,172 +851,467 @@ void glShow::impl::glShow2d::CreateTextShaderProgram()
     constexpr char* vShaderCode = GetTextVertexShader();
     constexpr char* fShaderCode = GetTextFragShader();
 
-    GLuint const vertexShader = CompileShader(vShaderCode, GL_VERTEX_SHADER);
-    GLuint const fragShader = CompileShader(fShaderCode, GL_FRAGMENT_SHADER);
+    mTextShaderProgram = BuildProgram(vShaderCode, fShaderCode);
 
-    mTextShaderProgram = LinkProgram(vertexShader, fragShader);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragShader);
+    mGL.UseProgram(mTextShaderProgram);
+    mTextColorLocation = glGetUniformLocation(mTextShaderProgram, "textColor");
+    SetTextProjection(mTextShaderProgram);
+}
 
-    glUseProgram(mTextShaderProgram);
+void glShow::impl::glShow2d::SetTextProjection(GLuint const program)
+{
+    // orthographic, origin at the bottom left, one unit per window pixel
+    float const sx = 2.0f / mTextSpaceWidth;
+    float const sy = 2.0f / mTextSpaceHeight;
     std::array<float, 4 * 4> const projectionText2 = {
         // clang-format off
-        0.002500f, 0.000000f, 0.000000f, 0.000000f,
-        0.000000f, 0.003333f, 0.000000f, 0.000000f,
-        0.000000f, 0.000000f, -1.000000f, 0.000000f,
-        -1.000000f, -1.000000f, 0.000000f, 1.000000f
+        sx,    0.0f,  0.0f,  0.0f,
+        0.0f,  sy,    0.0f,  0.0f,
+        0.0f,  0.0f,  -1.0f, 0.0f,
+        -1.0f, -1.0f, 0.0f,  1.0f
         // clang-format on
     };
-    glUniformMatrix4fv(glGetUniformLocation(mTextShaderProgram, "projection"),
-                       1, GL_FALSE, projectionText2.data());
+    mGL.UseProgram(program);
+    mGL.UniformMatrix4fv(glGetUniformLocation(program, "projection"),
+                         projectionText2.data());
 }
 
-void glShow::impl::glShow2d::InitTextRenderer(std::string const& pathToFont)
+void glShow::impl::glShow2d::UpdateTextProjections()
 {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
+    if (mTextShaderProgram != 0)
     {
-        std::cout << "ERROR::FREETYPE::COULD_NOT_INIT_FREETYPE_LIBRARY\n";
+        SetTextProjection(mTextShaderProgram);
     }
-
-    FT_Face face;
-    if (FT_New_Face(ft, pathToFont.c_str(), 0, &face))
+    if (mOverlayProgram != 0)
     {
-        std::cout << "ERROR::FREETYPE::FAILED_TO_LOAD_FONT\n";
-    }
-
-    // set size to load glyphs
-    FT_Set_Pixel_Sizes(face, 0, 40);
-
-    unsigned int totalWidth = 0;
-    unsigned int maxHeight = 0;
-
-    for (unsigned int c = 32; c < 128; c++)
-    {
-        // load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-        {
-            std::cout << "ERROR::FREETYPE::FAILED_TO_LOAD_GLYPH\n";
-            continue;
-        }
-        totalWidth += face->glyph->bitmap.width;
-        maxHeight = std::max(face->glyph->bitmap.rows, maxHeight);
+        SetTextProjection(mOverlayProgram);
     }
+}
 
-    mAtlasHeight = maxHeight;
-    mAtlasWidth = totalWidth;
+void glShow::impl::glShow2d::UploadGlyphAtlas(GlyphAtlas atlas)
+{
+    mGlyphAtlas = std::move(atlas);
+    // only the layout is needed from here on, the pixels live on the gpu
+    std::vector<unsigned char> const pixels = std::move(mGlyphAtlas.pixels);
 
-    glActiveTexture(GL_TEXTURE0);
-    glDeleteTextures(1, &mAtlasTexture);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.DeleteTexture(mAtlasTexture);
     glGenTextures(1, &mAtlasTexture);
-    glBindTexture(GL_TEXTURE_2D, mAtlasTexture);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, totalWidth, maxHeight, 0, GL_RED,
-                 GL_UNSIGNED_BYTE, 0);
+    mGL.BindTexture2D(mAtlasTexture);
 
     // disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    mGL.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    mGL.TexImage2D(GL_RED, mGlyphAtlas.width, mGlyphAtlas.height, GL_RED,
+                   pixels.data());
 
     /* Clamping to edges is important to prevent artifacts when scaling */
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    mGL.TexParameteri(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    mGL.TexParameteri(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     /* Linear filtering usually looks best for text */
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    unsigned xoffset = 0;
-    for (unsigned int c = 32; c < 128; ++c)
-    {
-        // load character glyph
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-        {
-            std::cout << "ERROR::FREETYPE::FAILED_TO_LOAD_GLYPH\n";
-            continue;
-        }
-        glTexSubImage2D(GL_TEXTURE_2D, 0, xoffset, 0, face->glyph->bitmap.width,
-                        face->glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE,
-                        face->glyph->bitmap.buffer);
-        Character temp = {{face->glyph->bitmap.width, face->glyph->bitmap.rows},
-                          {face->glyph->bitmap_left, face->glyph->bitmap_top},
-                          {face->glyph->advance.x, face->glyph->advance.y},
-                          {xoffset, face->glyph->bitmap.rows}};
-        mCharacters.insert(std::pair<char, Character>(
-            c, {{face->glyph->bitmap.width, face->glyph->bitmap.rows},
-                {face->glyph->bitmap_left, face->glyph->bitmap_top},
-                {face->glyph->advance.x, face->glyph->advance.y},
-                {xoffset, face->glyph->bitmap.rows}}));
-        xoffset += face->glyph->bitmap.width + 1;
-    }
-
-    // destroy FreeType once we're finished
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+    mGL.TexParameteri(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    mGL.TexParameteri(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+    // the resident batch lived in the old buffer
+    mTextDraws.clear();
+    mGL.DeleteBuffer(mTextVBO);
+    mGL.DeleteVertexArray(mTextVAO);
     glGenBuffers(1, &mTextVBO);
     glGenVertexArrays(1, &mTextVAO);
+
+    // the layout never changes, only the buffer contents do
+    mGL.BindVertexArray(mTextVAO);
+    mGL.BindBuffer(GL_ARRAY_BUFFER, mTextVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                          (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    mTextRendererInitialized = true;
 }
 
-void glShow::impl::glShow2d::RenderText(TextToRender const& textStuct)
+void glShow::impl::glShow2d::BuildTextBatch()
 {
-    glUseProgram(mTextShaderProgram);
-    glUniform3f(glGetUniformLocation(mTextShaderProgram, "textColor"),
-                textStuct.color.r, textStuct.color.g, textStuct.color.b);
+    mTextDraws.clear();
+    // only grows along with the queue, which already makes the frame
+    // allocate
+    mTextDraws.reserve(mTextsToRender.capacity());
+
+    // upper bound, characters without a glyph are skipped
+    std::size_t nGlyphs = 0;
+    for (auto const& text : mTextsToRender)
+    {
+        nGlyphs += text.text.size();
+    }
+    if (nGlyphs == 0)
+    {
+        return;
+    }
 
-    float cur_x = textStuct.x;
-    std::vector<float> allVertices(textStuct.text.size() * 6 * 4);
-    for (size_t i = 0; i < textStuct.text.size(); ++i)
+    float* const allVertices =
+        mFrameArena.AllocateArray<float>(nGlyphs * 6 * 4);
+    std::size_t glyph = 0;
+    for (auto const& text : mTextsToRender)
     {
-        const Character& ch = mCharacters.at(textStuct.text[i]);
+        std::size_t const firstGlyph = glyph;
+        float cur_x = text.x;
+        for (char const c : text.text)
+        {
+            Character const* const ch = FindGlyph(mGlyphAtlas, c);
+            if (ch == nullptr)
+            {
+                continue;
+            }
+            GlyphQuad const q =
+                PlaceGlyph(mGlyphAtlas, *ch, cur_x, text.y, text.scale);
+
+            float const quad[6 * 4] = {
+                // clang-format off
+                    // position         // texture coords
+                    q.left, q.top,      q.uLeft, q.vTop,
+                    q.left, q.bottom,   q.uLeft, q.vBottom,
+                    q.right, q.bottom,  q.uRight, q.vBottom,
+                    q.left, q.top,      q.uLeft, q.vTop,
+                    q.right, q.bottom,  q.uRight, q.vBottom,
+                    q.right, q.top,     q.uRight, q.vTop
+                // clang-format on
+            };
+
+            std::copy(std::cbegin(quad), std::cend(quad),
+                      allVertices + 6 * 4 * glyph);
+            ++glyph;
+        }
 
-        float xpos = cur_x + ch.Bearing.x * textStuct.scale;
-        float ypos = textStuct.y - (ch.Size.y - ch.Bearing.y) * textStuct.scale;
+        if (glyph > firstGlyph)
+        {
+            mTextDraws.push_back(
+                {static_cast<GLint>(6 * firstGlyph),
+                 static_cast<GLsizei>(6 * (glyph - firstGlyph)), text.color});
+        }
+    }
+    if (glyph == 0)
+    {
+        return;
+    }
 
-        float w = ch.Size.x * textStuct.scale;
-        float h = ch.Size.y * textStuct.scale;
-        // update VBO for each character
+    // the whole batch goes up at once and stays until the next frame, so
+    // redrawing it never needs the cpu side text again
+    mGL.BindVertexArray(mTextVAO);
+    mGL.BindBuffer(GL_ARRAY_BUFFER, mTextVBO);
+    mGL.BufferData(GL_ARRAY_BUFFER, glyph * 6 * 4 * sizeof(float),
+                   allVertices, GL_DYNAMIC_DRAW);
+}
 
-        std::vector<float> temp = {
-            // clang-format off
-                // position         // texture coords
-                xpos, ypos + h,     (float)ch.Offset.x / mAtlasWidth, 0.0f,
-                xpos, ypos,         (float)ch.Offset.x / mAtlasWidth, (float)ch.Offset.y / mAtlasHeight,
-                xpos + w, ypos,     (float)(ch.Offset.x + ch.Size.x) / mAtlasWidth, (float)ch.Offset.y / mAtlasHeight,
-                xpos, ypos + h,     (float)ch.Offset.x / mAtlasWidth, 0.0f,
-                xpos + w, ypos,     (float)(ch.Offset.x + ch.Size.x) / mAtlasWidth, (float)ch.Offset.y / mAtlasHeight,
-                xpos + w, ypos + h, (float)(ch.Offset.x + ch.Size.x) / mAtlasWidth, 0.0f
-            // clang-format on
-        };
+void glShow::impl::glShow2d::RenderTextBatch()
+{
+    if (mTextDraws.empty())
+    {
+        return;
+    }
 
-        std::copy(temp.cbegin(), temp.cend(), allVertices.begin() + 6 * 4 * i);
+    mGL.UseProgram(mTextShaderProgram);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mAtlasTexture);
+    mGL.BindVertexArray(mTextVAO);
+    for (auto const& draw : mTextDraws)
+    {
+        mGL.Uniform3f(mTextColorLocation, draw.color.r, draw.color.g,
+                      draw.color.b);
+        mGL.DrawArrays(GL_TRIANGLES, draw.first, draw.count);
+    }
+}
 
-        // now advance cursors for next glyph (note that advance is
-        // number of 1/64 pixels)
-        cur_x += (ch.Advance.x >> 6) * textStuct.scale;
+void glShow::impl::glShow2d::EnablePixelStats(bool const overlay)
+{
+    if (!mPixelStatsEnabled)
+    {
+        InitPixelStats();
     }
+    mPixelStatsEnabled = true;
+    mPixelStatsOverlay = overlay;
+}
+
+void glShow::impl::glShow2d::DisablePixelStats()
+{
+    DeletePixelStats();
+    mPixelStatsEnabled = false;
+    mPixelStatsOverlay = false;
+    mPixelStatsReady = false;
+}
+
+glShow::impl::PixelStats const* glShow::impl::glShow2d::GetPixelStats() const
+{
+    return mPixelStatsReady ? &mPixelStats : nullptr;
+}
 
-    // load glyph atlas
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mAtlasTexture);
+void glShow::impl::glShow2d::InitPixelStats()
+{
+    mHistogramProgram =
+        BuildProgram(GetHistogramVertexShader(), GetHistogramFragShader());
+    mGL.UseProgram(mHistogramProgram);
+    mGL.Uniform1i(glGetUniformLocation(mHistogramProgram, "image"), 0);
+
+    // core profile draws need a vao even without attributes
+    glGenVertexArrays(1, &mHistogramVAO);
+
+    // float counts, limited to kGpuCountLimit per bin
+    glGenTextures(1, &mHistogramTexture);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mHistogramTexture);
+    mGL.TexImage2D(GL_R32F, PixelStats::kBins, PixelStats::kMaxChannels,
+                   GL_RED, nullptr);
+    mGL.TexParameteri(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    mGL.TexParameteri(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &mHistogramFramebuffer);
+    mGL.BindFramebuffer(mHistogramFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           mHistogramTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Histogram framebuffer incomplete\n";
+    }
+    mGL.BindFramebuffer(0);
 
-    // update content of VBO memory
-    glBindVertexArray(mTextVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, mTextVBO);
-    glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(float),
-                 allVertices.data(), GL_DYNAMIC_DRAW);
+    glGenBuffers(kStatsReadbacks, mStatsBuffers.data());
+    for (GLuint const buffer : mStatsBuffers)
+    {
+        mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        mGL.BufferData(GL_PIXEL_PACK_BUFFER,
+                       PixelStats::kBins * PixelStats::kMaxChannels *
+                           sizeof(float),
+                       nullptr, GL_STREAM_READ);
+    }
+    mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    mOverlayProgram =
+        BuildProgram(GetTextVertexShader(), GetOverlayFragShader());
+    mGL.UseProgram(mOverlayProgram);
+    mGL.Uniform1i(glGetUniformLocation(mOverlayProgram, "histogram"), 0);
+    mOverlayChannelsLocation =
+        glGetUniformLocation(mOverlayProgram, "channels");
+    mOverlayInvPeakLocation = glGetUniformLocation(mOverlayProgram, "invPeak");
+    SetTextProjection(mOverlayProgram);
+
+    // same layout as the text quads, the overlay never moves
+    float const left = kOverlayLeft;
+    float const right = kOverlayLeft + kOverlayWidth;
+    float const bottom = kOverlayBottom;
+    float const top = kOverlayBottom + kOverlayHeight;
+    std::array<float, 6 * 4> const quad = {
+        // clang-format off
+            // position      // texture coords
+            left, top,       0.0f, 1.0f,
+            left, bottom,    0.0f, 0.0f,
+            right, bottom,   1.0f, 0.0f,
+            left, top,       0.0f, 1.0f,
+            right, bottom,   1.0f, 0.0f,
+            right, top,      1.0f, 1.0f
+        // clang-format on
+    };
+    glGenVertexArrays(1, &mOverlayVAO);
+    glGenBuffers(1, &mOverlayVBO);
+    mGL.BindVertexArray(mOverlayVAO);
+    mGL.BindBuffer(GL_ARRAY_BUFFER, mOverlayVBO);
+    mGL.BufferData(GL_ARRAY_BUFFER, sizeof(quad), quad.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
                           (void*)0);
     glEnableVertexAttribArray(0);
-
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
                           (void*)(2 * sizeof(float)));
     glEnableVertexAttribArray(1);
+}
 
-    // render quads
-    glDrawArrays(GL_TRIANGLES, 0, 6 * (GLsizei)textStuct.text.size());
+void glShow::impl::glShow2d::DeletePixelStats()
+{
+    for (GLsync& fence : mStatsFences)
+    {
+        if (fence != nullptr)
+        {
+            mGL.DeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    for (GLuint& buffer : mStatsBuffers)
+    {
+        mGL.DeleteBuffer(buffer);
+        buffer = 0;
+    }
+    mGL.DeleteFramebuffer(mHistogramFramebuffer);
+    mHistogramFramebuffer = 0;
+    mGL.DeleteTexture(mHistogramTexture);
+    mHistogramTexture = 0;
+    mGL.DeleteVertexArray(mHistogramVAO);
+    mHistogramVAO = 0;
+    mGL.DeleteProgram(mHistogramProgram);
+    mHistogramProgram = 0;
+
+    mGL.DeleteVertexArray(mOverlayVAO);
+    mOverlayVAO = 0;
+    mGL.DeleteBuffer(mOverlayVBO);
+    mOverlayVBO = 0;
+    mGL.DeleteProgram(mOverlayProgram);
+    mOverlayProgram = 0;
+}
 
-    // unbind all buffers
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+void glShow::impl::glShow2d::CollectPixelStats()
+{
+    for (;;)
+    {
+        // the gpu finishes readbacks in order, so only the oldest can be
+        // next
+        std::size_t oldest = kStatsReadbacks;
+        for (std::size_t i = 0; i < kStatsReadbacks; ++i)
+        {
+            if (mStatsFences[i] != nullptr &&
+                (oldest == kStatsReadbacks ||
+                 mStatsFrames[i] < mStatsFrames[oldest]))
+            {
+                oldest = i;
+            }
+        }
+        if (oldest == kStatsReadbacks)
+        {
+            return;
+        }
+
+        GLenum const status = mGL.ClientWaitSync(mStatsFences[oldest], 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            return;
+        }
+        mGL.DeleteSync(mStatsFences[oldest]);
+        mStatsFences[oldest] = nullptr;
+
+        mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, mStatsBuffers[oldest]);
+        auto const counts = static_cast<float const*>(mGL.MapBufferRange(
+            GL_PIXEL_PACK_BUFFER,
+            PixelStats::kBins * PixelStats::kMaxChannels * sizeof(float),
+            GL_MAP_READ_BIT));
+        if (counts != nullptr)
+        {
+            mPixelStats.nChannels = mStatsChannels[oldest];
+            for (int c = 0; c < mPixelStats.nChannels; ++c)
+            {
+                mPixelStats.saturated[c] = false;
+                for (int v = 0; v < PixelStats::kBins; ++v)
+                {
+                    std::uint32_t const count = std::min(
+                        static_cast<std::uint32_t>(
+                            counts[c * PixelStats::kBins + v]),
+                        PixelStats::kGpuCountLimit);
+                    mPixelStats.histogram[c][v] = count;
+                    mPixelStats.saturated[c] =
+                        mPixelStats.saturated[c] ||
+                        count == PixelStats::kGpuCountLimit;
+                }
+            }
+            mGL.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            SummarizeHistogram(mPixelStats);
+            mPixelStatsReady = true;
+        }
+        mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+}
+
+void glShow::impl::glShow2d::RenderHistogram()
+{
+    int const nChannels =
+        std::min(mImageChannels, static_cast<int>(PixelStats::kMaxChannels));
+    if (nChannels <= 0)
+    {
+        return;
+    }
+
+    // RenderResidentFrame sets the window state back, only when it differs
+    mGL.BindFramebuffer(mHistogramFramebuffer);
+    mGL.Viewport(0, 0, PixelStats::kBins, PixelStats::kMaxChannels);
+    mGL.BlendFunc(GL_ONE, GL_ONE);
+    mGL.Clear(GL_COLOR_BUFFER_BIT);
+
+    mGL.UseProgram(mHistogramProgram);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mImageTexture);
+    mGL.BindVertexArray(mHistogramVAO);
+    mGL.DrawArraysInstanced(GL_POINTS, mImageWidth * mImageHeight, nChannels);
+
+    // a readback still in flight keeps its buffer, this frame is then only
+    // histogrammed for the overlay
+    for (std::size_t i = 0; i < kStatsReadbacks; ++i)
+    {
+        if (mStatsFences[i] == nullptr)
+        {
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, mStatsBuffers[i]);
+            mGL.ReadPixels(PixelStats::kBins, nChannels, GL_RED, GL_FLOAT,
+                           nullptr);
+            mGL.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            mStatsFences[i] = mGL.FenceSync();
+            mStatsFrames[i] = mFrameNumber;
+            mStatsChannels[i] = nChannels;
+            break;
+        }
+    }
+}
+
+void glShow::impl::glShow2d::RenderPixelStatsOverlay()
+{
+    // bars come from this frame's histogram, but are scaled by the peak of
+    // the last one read back
+    if (!mPixelStatsReady)
+    {
+        return;
+    }
+    std::uint32_t peak = 1;
+    for (int c = 0; c < mPixelStats.nChannels; ++c)
+    {
+        for (std::uint32_t const count : mPixelStats.histogram[c])
+        {
+            peak = std::max(peak, count);
+        }
+    }
+
+    mGL.UseProgram(mOverlayProgram);
+    mGL.Uniform1i(mOverlayChannelsLocation,
+                  std::min(mImageChannels,
+                           static_cast<int>(PixelStats::kMaxChannels)));
+    mGL.Uniform1f(mOverlayInvPeakLocation, 1.0f / peak);
+    mGL.ActiveTexture(GL_TEXTURE0);
+    mGL.BindTexture2D(mHistogramTexture);
+    mGL.BindVertexArray(mOverlayVAO);
+    mGL.DrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void glShow::impl::glShow2d::QueuePixelStatsLabels()
+{
+    if (!mTextRendererInitialized || !mPixelStatsReady)
+    {
+        return;
+    }
+    static constexpr char kChannelNames[] = "RGBA";
+    static constexpr TextColor kChannelColors[] = {
+        {1.0f, 0.4f, 0.4f}, {0.4f, 1.0f, 0.4f}, {0.5f, 0.6f, 1.0f},
+        {0.8f, 0.8f, 0.8f}};
+    constexpr std::size_t kLineLength = 64;
+    for (int c = 0; c < mPixelStats.nChannels; ++c)
+    {
+        bool const gray = mPixelStats.nChannels == 1;
+        char* const line = mFrameArena.AllocateArray<char>(kLineLength);
+        int const length = std::snprintf(
+            line, kLineLength, "%c mean %.1f min %d max %d clip %u/%u",
+            gray ? 'V' : kChannelNames[c], mPixelStats.mean[c],
+            mPixelStats.min[c], mPixelStats.max[c],
+            static_cast<unsigned>(mPixelStats.clippedLow[c]),
+            static_cast<unsigned>(mPixelStats.clippedHigh[c]));
+        float const y = kOverlayBottom + kOverlayHeight + 6.0f +
+                        kOverlayLineHeight * (mPixelStats.nChannels - 1 - c);
+        mTextsToRender.push_back(
+            {std::string_view(line, std::min<std::size_t>(std::max(length, 0),
+                                                          kLineLength - 1)),
+             kOverlayLeft, y, kOverlayTextScale,
+             gray ? kChannelColors[3] : kChannelColors[c]});
+    }
 }
@@ -0,0 +1,111 @@
+#include "glShow2dParallel.h"
+
+glShow::impl::WorkerPool::WorkerPool()
+    : mGeneration{0}, mStopping{false}, mJob{nullptr}, mJobFn{nullptr},
+      mCount{0}, mChunkSize{0}, mChunks{0}, mPending{0}
+{
+}
+
+glShow::impl::WorkerPool::~WorkerPool() { Stop(); }
+
+void glShow::impl::WorkerPool::Start(unsigned nThreads)
+{
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (nThreads == Size())
+    {
+        return;
+    }
+    Stop();
+
+    // workers only run jobs posted after this point, even if they get to
+    // wait on mWake after the first job was posted
+    std::uint64_t const generation = mGeneration;
+    mWorkers.reserve(nThreads - 1);
+    for (unsigned chunk = 1; chunk < nThreads; ++chunk)
+    {
+        mWorkers.emplace_back(
+            [this, chunk, generation]() { WorkerLoop(chunk, generation); });
+    }
+}
+
+void glShow::impl::WorkerPool::Stop()
+{
+    if (mWorkers.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> const lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+    mStopping = false;
+}
+
+void glShow::impl::WorkerPool::Run(int const count, unsigned const nChunks,
+                                   void const* const job, JobFn const jobFn)
+{
+    {
+        std::lock_guard<std::mutex> const lock(mMutex);
+        mJob = job;
+        mJobFn = jobFn;
+        mCount = count;
+        mChunkSize = (count + static_cast<int>(nChunks) - 1) /
+                     static_cast<int>(nChunks);
+        mChunks = nChunks;
+        mPending = nChunks - 1;
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    RunChunk(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mPending == 0; });
+}
+
+void glShow::impl::WorkerPool::RunChunk(unsigned const chunk) const
+{
+    int const first = static_cast<int>(chunk) * mChunkSize;
+    int const last = std::min(mCount, first + mChunkSize);
+    if (first < last)
+    {
+        mJobFn(mJob, first, last, chunk);
+    }
+}
+
+void glShow::impl::WorkerPool::WorkerLoop(unsigned const chunk,
+                                          std::uint64_t seen)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;)
+    {
+        mWake.wait(lock,
+                   [this, seen]() { return mStopping || mGeneration != seen; });
+        if (mStopping)
+        {
+            return;
+        }
+        seen = mGeneration;
+        if (chunk >= mChunks)
+        {
+            continue;
+        }
+
+        lock.unlock();
+        RunChunk(chunk);
+        lock.lock();
+        if (--mPending == 0)
+        {
+            mDone.notify_one();
+        }
+    }
+}
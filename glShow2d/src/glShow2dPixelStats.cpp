@@ -0,0 +1,57 @@
+#include "glShow2dPixelStats.h"
+
+#include <algorithm>
+
+void glShow::impl::SummarizeHistogram(PixelStats& stats)
+{
+    for (int c = 0; c < stats.nChannels; ++c)
+    {
+        auto const& bins = stats.histogram[c];
+
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        int lowest = PixelStats::kBins;
+        int highest = -1;
+        for (int v = 0; v < PixelStats::kBins; ++v)
+        {
+            if (bins[v] == 0)
+            {
+                continue;
+            }
+            count += bins[v];
+            sum += static_cast<std::uint64_t>(bins[v]) * v;
+            lowest = std::min(lowest, v);
+            highest = v;
+        }
+
+        stats.mean[c] = count > 0 ? static_cast<float>(sum) / count : 0.0f;
+        stats.min[c] = static_cast<unsigned char>(count > 0 ? lowest : 0);
+        stats.max[c] = static_cast<unsigned char>(count > 0 ? highest : 0);
+        stats.clippedLow[c] = bins[0];
+        stats.clippedHigh[c] = bins[PixelStats::kBins - 1];
+    }
+}
+
+void glShow::impl::ComputePixelStats(unsigned char const* const data,
+                                     int const width, int const height,
+                                     int const nChannels, PixelStats& stats)
+{
+    stats.nChannels = std::min(nChannels, PixelStats::kMaxChannels);
+    for (auto& bins : stats.histogram)
+    {
+        bins.fill(0);
+    }
+    stats.saturated.fill(false);
+
+    std::size_t const nPixels = static_cast<std::size_t>(width) * height;
+    for (std::size_t i = 0; i < nPixels; ++i)
+    {
+        unsigned char const* const pixel = data + i * nChannels;
+        for (int c = 0; c < stats.nChannels; ++c)
+        {
+            ++stats.histogram[c][pixel[c]];
+        }
+    }
+
+    SummarizeHistogram(stats);
+}
@@ -0,0 +1,202 @@
+#include "glShow2dProgramCache.h"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr std::array<char, 4> kMagic = {'G', 'S', '2', 'D'};
+
+// FNV-1a, stable across runs unlike std::hash
+std::uint64_t Hash(std::uint64_t hash, char const* const str)
+{
+    for (char const* c = str; *c != '\0'; ++c)
+    {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 1099511628211ull;
+    }
+    // separator, so that "ab" + "c" and "a" + "bc" differ
+    hash ^= 0xff;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+// Process id and a random suffix, so viewers starting at the same time never
+// write the same temporary file
+std::string UniqueSuffix()
+{
+#ifdef _WIN32
+    unsigned long long const pid = _getpid();
+#else
+    unsigned long long const pid = getpid();
+#endif
+    std::random_device random;
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".%llu-%08x.tmp", pid,
+                  static_cast<unsigned>(random()));
+    return suffix;
+}
+
+std::string GetGLString(GLenum const name)
+{
+    auto const str = reinterpret_cast<char const*>(glGetString(name));
+    return str != nullptr ? str : "";
+}
+} // namespace
+
+glShow::impl::ProgramBinaryCache::ProgramBinaryCache() : mEnabled{false} {}
+
+glShow::impl::ProgramBinaryCache::ProgramBinaryCache(
+    std::filesystem::path directory)
+    : mEnabled{false}, mDirectory{std::move(directory)}
+{
+    // program binaries are core in 4.1. Older contexts leave the binary and
+    // program parameter entry points unloaded, and drivers may still offer
+    // no binary formats.
+    if (!GLAD_GL_VERSION_4_1)
+    {
+        return;
+    }
+    GLint nFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+    if (nFormats <= 0)
+    {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory, error);
+    if (error)
+    {
+        return;
+    }
+
+    mDriver = GetGLString(GL_VENDOR) + '\n' + GetGLString(GL_RENDERER) + '\n' +
+              GetGLString(GL_VERSION);
+    mEnabled = true;
+}
+
+GLuint
+glShow::impl::ProgramBinaryCache::Load(char const* const vShaderCode,
+                                       char const* const fShaderCode) const
+{
+    if (!mEnabled)
+    {
+        return 0;
+    }
+
+    std::ifstream file(PathFor(vShaderCode, fShaderCode), std::ios::binary);
+    if (!file)
+    {
+        return 0;
+    }
+
+    std::array<char, 4> magic;
+    GLenum format;
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    if (!file || magic != kMagic)
+    {
+        return 0;
+    }
+    std::vector<char> const binary{std::istreambuf_iterator<char>(file),
+                                   std::istreambuf_iterator<char>()};
+    if (binary.empty())
+    {
+        return 0;
+    }
+
+    GLuint const program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+
+    // fails if the driver changed in a way the version string does not show
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void glShow::impl::ProgramBinaryCache::Store(
+    GLuint const program, char const* const vShaderCode,
+    char const* const fShaderCode) const
+{
+    if (!mEnabled)
+    {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format;
+    glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+    // write to a temporary of this process and rename it, so a concurrently
+    // starting viewer never reads or writes a partial file
+    std::filesystem::path const path = PathFor(vShaderCode, fShaderCode);
+    std::filesystem::path tmp = path;
+    tmp += UniqueSuffix();
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write(kMagic.data(), kMagic.size());
+        file.write(reinterpret_cast<char const*>(&format), sizeof(format));
+        file.write(binary.data(), binary.size());
+        if (!file)
+        {
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmp, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tmp, error);
+    }
+}
+
+std::filesystem::path glShow::impl::ProgramBinaryCache::DefaultDirectory()
+{
+    std::error_code error;
+    std::filesystem::path const tmp =
+        std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        return {};
+    }
+    return tmp / "glShow2d" / "programs";
+}
+
+std::filesystem::path glShow::impl::ProgramBinaryCache::PathFor(
+    char const* const vShaderCode, char const* const fShaderCode) const
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    hash = Hash(hash, mDriver.c_str());
+    hash = Hash(hash, vShaderCode);
+    hash = Hash(hash, fShaderCode);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin",
+                  static_cast<unsigned long long>(hash));
+    return mDirectory / name;
+}
@@ -0,0 +1,431 @@
+#include "glShow2dSoftware.h"
+#include "glShow2dSimd.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+// Room for the queued text of a typical frame
+constexpr std::size_t kFrameArenaSize = 16 * 1024;
+
+// Below this many glyphs per frame, waking the workers costs more than it
+// saves
+constexpr std::size_t kParallelGlyphThreshold = 64;
+
+// dst[i] += (src[i] - dst[i]) * weight[i], rounded back to 8 bits. This is
+// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) with every byte of the
+// interleaved destination as its own lane.
+void BlendSpan(unsigned char* const dst, float const* const src,
+               float const* const weight, std::size_t const n)
+{
+    std::size_t i = 0;
+#ifdef GLSHOW2D_SSE2
+    __m128i const zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i const d8 =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+        __m128i const d16[2] = {_mm_unpacklo_epi8(d8, zero),
+                                _mm_unpackhi_epi8(d8, zero)};
+        __m128i r32[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            __m128 const d = _mm_cvtepi32_ps(
+                k % 2 == 0 ? _mm_unpacklo_epi16(d16[k / 2], zero)
+                           : _mm_unpackhi_epi16(d16[k / 2], zero));
+            __m128 const s = _mm_loadu_ps(src + i + 4 * k);
+            __m128 const w = _mm_loadu_ps(weight + i + 4 * k);
+            r32[k] = _mm_cvtps_epi32(
+                _mm_add_ps(d, _mm_mul_ps(_mm_sub_ps(s, d), w)));
+        }
+        __m128i const r8 = _mm_packus_epi16(_mm_packs_epi32(r32[0], r32[1]),
+                                            _mm_packs_epi32(r32[2], r32[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r8);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        float const d = dst[i];
+        dst[i] = static_cast<unsigned char>(d + (src[i] - d) * weight[i] +
+                                            0.5f);
+    }
+}
+
+// Bilinear sample of the glyph atlas with GL_CLAMP_TO_EDGE, in [0, 255]
+float SampleAtlas(glShow::impl::GlyphAtlas const& atlas, float const u,
+                  float const v)
+{
+    float const tx = u * atlas.width - 0.5f;
+    float const ty = v * atlas.height - 0.5f;
+    float const x0f = std::floor(tx);
+    float const y0f = std::floor(ty);
+    float const fx = tx - x0f;
+    float const fy = ty - y0f;
+
+    int const maxX = static_cast<int>(atlas.width) - 1;
+    int const maxY = static_cast<int>(atlas.height) - 1;
+    int const x0 = std::clamp(static_cast<int>(x0f), 0, maxX);
+    int const x1 = std::clamp(static_cast<int>(x0f) + 1, 0, maxX);
+    int const y0 = std::clamp(static_cast<int>(y0f), 0, maxY);
+    int const y1 = std::clamp(static_cast<int>(y0f) + 1, 0, maxY);
+
+    unsigned char const* const row0 = atlas.pixels.data() + y0 * atlas.width;
+    unsigned char const* const row1 = atlas.pixels.data() + y1 * atlas.width;
+    float const top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+    float const bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+// First and one past last pixel whose center lies in [lo, hi), clipped to
+// [0, size)
+void CoveredPixels(float const lo, float const hi, int const size, int& first,
+                   int& last)
+{
+    first = std::max(0, static_cast<int>(std::ceil(lo - 0.5f)));
+    last = std::min(size, static_cast<int>(std::ceil(hi - 0.5f)));
+}
+} // namespace
+
+// Glyph quad in target pixel coordinates
+struct glShow::impl::glShow2dSoftware::PlacedGlyph
+{
+    GlyphQuad quad;
+    TextColor color;
+};
+
+// Source texels and weight of one output column or row
+struct glShow::impl::glShow2dSoftware::Tap
+{
+    int i0, i1;
+    float f;
+};
+
+glShow::impl::glShow2dSoftware::glShow2dSoftware(unsigned char* const target,
+                                                 unsigned const width,
+                                                 unsigned const height,
+                                                 int const nChannels,
+                                                 unsigned const nThreads)
+    : mTarget{target}, mWidth{width}, mHeight{height}, mChannels{nChannels},
+      mPool{}, mTextRendererInitialized{false}, mGlyphAtlas{0, 0, {}, {}},
+      mFrameArena{kFrameArenaSize}, mFrameStartAllocations{0},
+      mSteadyCapacity{0}, mStartupTimings{}, mPixelStatsEnabled{false},
+      mPixelStatsReady{false}, mPixelStats{}, mWokenUp{false}
+{
+    if (nChannels != 3 && nChannels != 4)
+    {
+        throw std::invalid_argument(
+            "Software renderer needs a 3 or 4 channel target.\n");
+    }
+    mPool.Start(nThreads);
+}
+
+glShow::impl::glShow2dSoftware::glShow2dSoftware(
+    unsigned char* const target, unsigned const width, unsigned const height,
+    int const nChannels, std::string const& pathToFont,
+    unsigned const nThreads)
+    : glShow2dSoftware(target, width, height, nChannels, nThreads)
+{
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+    auto const start = std::chrono::steady_clock::now();
+
+    EnableOrReInitTextRenderer(pathToFont);
+
+    mStartupTimings.fontRasterization = mStartupTimings.total =
+        Milliseconds(std::chrono::steady_clock::now() - start).count();
+}
+
+glShow::impl::glShow2dSoftware::~glShow2dSoftware() { mPool.Stop(); }
+
+void glShow::impl::glShow2dSoftware::EnableOrReInitTextRenderer(
+    std::string const& pathToFont)
+{
+    mGlyphAtlas = RasterizeGlyphAtlas(pathToFont);
+    mTextRendererInitialized = true;
+
+    // a source and a weight row per worker, the target size never changes
+    std::size_t const rowBytes = static_cast<std::size_t>(mWidth) * mChannels;
+    mTextScratch.resize(2 * rowBytes * mPool.Size());
+}
+
+void glShow::impl::glShow2dSoftware::Draw(unsigned char const* const data,
+                                          int const width, int const height,
+                                          int const nChannels)
+{
+    AllocationScope const allocationScope;
+    if (mPixelStatsEnabled)
+    {
+        ComputePixelStats(data, width, height, nChannels, mPixelStats);
+        mPixelStatsReady = true;
+    }
+    CompositeImage(data, width, height, nChannels);
+    CompositeText();
+
+    // Same steady state check as the GL backend, over all per frame vectors
+    std::size_t const capacity = SteadyCapacity();
+    bool const steadyState =
+        !mFrameArena.Grew() && capacity == mSteadyCapacity;
+    assert(!steadyState || CountedAllocations() == mFrameStartAllocations);
+    (void)steadyState;
+
+    mFrameArena.Reset();
+    mSteadyCapacity = capacity;
+    mFrameStartAllocations = CountedAllocations();
+}
+
+std::size_t glShow::impl::glShow2dSoftware::SteadyCapacity() const
+{
+    return mTextsToRender.capacity() + mPlacedGlyphs.capacity() +
+           mColumnTaps.capacity() + mDecompressed.capacity();
+}
+
+void glShow::impl::glShow2dSoftware::DisablePixelStats()
+{
+    mPixelStatsEnabled = false;
+    mPixelStatsReady = false;
+}
+
+bool glShow::impl::glShow2dSoftware::ReadFrame(unsigned char* const dst,
+                                               unsigned const width,
+                                               unsigned const height) const
+{
+    if (width > mWidth || height > mHeight)
+    {
+        return false;
+    }
+
+    for (unsigned y = 0; y < height; ++y)
+    {
+        unsigned char const* const row =
+            mTarget + static_cast<std::size_t>(y) * mWidth * mChannels;
+        unsigned char* const out =
+            dst + static_cast<std::size_t>(y) * width * 3;
+        for (unsigned x = 0; x < width; ++x)
+        {
+            std::copy_n(row + x * mChannels, 3, out + x * 3);
+        }
+    }
+    return true;
+}
+
+void glShow::impl::glShow2dSoftware::WaitEvents(double const timeoutSeconds)
+{
+    std::unique_lock<std::mutex> lock(mWakeMutex);
+    auto const wokenUp = [this]() { return mWokenUp; };
+    if (timeoutSeconds < 0.0)
+    {
+        mWakeCondition.wait(lock, wokenUp);
+    }
+    else
+    {
+        mWakeCondition.wait_for(
+            lock, std::chrono::duration<double>(timeoutSeconds), wokenUp);
+    }
+    mWokenUp = false;
+}
+
+void glShow::impl::glShow2dSoftware::WakeUp()
+{
+    {
+        std::lock_guard<std::mutex> const lock(mWakeMutex);
+        mWokenUp = true;
+    }
+    mWakeCondition.notify_all();
+}
+
+void glShow::impl::glShow2dSoftware::DrawCompressed(
+    unsigned char const* const data, std::size_t const size, int const width,
+    int const height, BlockFormat const format)
+{
+    if (size < CompressedImageSize(format, width, height))
+    {
+        std::cout << "Compressed image data too small\n";
+        return;
+    }
+
+    if (format == BlockFormat::BC1)
+    {
+        mDecompressed.resize(static_cast<std::size_t>(width) * height * 3);
+        DecompressBC1(data, width, height, mDecompressed.data());
+        Draw(mDecompressed.data(), width, height, 3);
+    }
+    else if (format == BlockFormat::BC4)
+    {
+        mDecompressed.resize(static_cast<std::size_t>(width) * height);
+        DecompressBC4(data, width, height, mDecompressed.data());
+        Draw(mDecompressed.data(), width, height, 1);
+    }
+    else
+    {
+        std::cout << "BC7 is not supported by the software renderer\n";
+    }
+}
+
+void glShow::impl::glShow2dSoftware::DrawText(std::string_view const text,
+                                              float const x, float const y,
+                                              float const scale,
+                                              TextColor const& color)
+{
+    AllocationScope const allocationScope;
+    if (!mTextRendererInitialized)
+    {
+        std::cout << "Text renderer not initialized\n";
+    }
+    else
+    {
+        mTextsToRender.push_back({mFrameArena.Copy(text), x, y, scale, color});
+    }
+}
+
+// Stretches the image over the whole target with GL_LINEAR sampling and
+// blends it over black, the same as the textured quad in the GL backend.
+void glShow::impl::glShow2dSoftware::CompositeImage(
+    unsigned char const* const data, int const width, int const height,
+    int const nChannels)
+{
+    std::size_t const rowBytes = static_cast<std::size_t>(mWidth) * mChannels;
+    if (data == nullptr || width <= 0 || height <= 0 ||
+        (nChannels != 1 && nChannels != 3 && nChannels != 4))
+    {
+        std::memset(mTarget, 0, rowBytes * mHeight);
+        return;
+    }
+
+    auto const makeTap = [](unsigned const dst, int const srcSize,
+                            unsigned const dstSize) {
+        float const s = (dst + 0.5f) * srcSize / dstSize - 0.5f;
+        float const s0 = std::floor(s);
+        int const i0 = static_cast<int>(s0);
+        return Tap{std::clamp(i0, 0, srcSize - 1),
+                   std::clamp(i0 + 1, 0, srcSize - 1), s - s0};
+    };
+
+    mColumnTaps.resize(mWidth);
+    for (unsigned x = 0; x < mWidth; ++x)
+    {
+        mColumnTaps[x] = makeTap(x, width, mWidth);
+    }
+
+    mPool.ParallelFor(static_cast<int>(mHeight), [&](int const first,
+                                                     int const last,
+                                                     unsigned) {
+        for (int y = first; y < last; ++y)
+        {
+            Tap const row = makeTap(y, height, mHeight);
+            unsigned char const* const src0 =
+                data + static_cast<std::size_t>(row.i0) * width * nChannels;
+            unsigned char const* const src1 =
+                data + static_cast<std::size_t>(row.i1) * width * nChannels;
+            unsigned char* const out = mTarget + rowBytes * y;
+
+            for (unsigned x = 0; x < mWidth; ++x)
+            {
+                Tap const& col = mColumnTaps[x];
+                float rgba[4] = {0.0f, 0.0f, 0.0f, 255.0f};
+                for (int c = 0; c < nChannels; ++c)
+                {
+                    float const p00 = src0[col.i0 * nChannels + c];
+                    float const p10 = src0[col.i1 * nChannels + c];
+                    float const p01 = src1[col.i0 * nChannels + c];
+                    float const p11 = src1[col.i1 * nChannels + c];
+                    float const top = p00 + (p10 - p00) * col.f;
+                    float const bottom = p01 + (p11 - p01) * col.f;
+                    rgba[c] = top + (bottom - top) * row.f;
+                }
+
+                float const alpha = rgba[3] / 255.0f;
+                for (int c = 0; c < mChannels; ++c)
+                {
+                    out[x * mChannels + c] =
+                        static_cast<unsigned char>(rgba[c] * alpha + 0.5f);
+                }
+            }
+        }
+    });
+}
+
+void glShow::impl::glShow2dSoftware::CompositeText()
+{
+    // text coordinates are target pixels, like window pixels in glShow2d
+    mPlacedGlyphs.clear();
+    for (auto const& text : mTextsToRender)
+    {
+        float cur_x = text.x;
+        for (char const c : text.text)
+        {
+            Character const* const ch = FindGlyph(mGlyphAtlas, c);
+            if (ch == nullptr)
+            {
+                continue;
+            }
+            GlyphQuad const q =
+                PlaceGlyph(mGlyphAtlas, *ch, cur_x, text.y, text.scale);
+            mPlacedGlyphs.push_back({q, text.color});
+        }
+    }
+    mTextsToRender.clear();
+
+    if (mPlacedGlyphs.empty())
+    {
+        return;
+    }
+
+    unsigned const maxChunks =
+        mPlacedGlyphs.size() < kParallelGlyphThreshold ? 1 : 0;
+    std::size_t const rowBytes = static_cast<std::size_t>(mWidth) * mChannels;
+
+    // each thread owns a band of rows and draws the part of every glyph that
+    // falls into it, so no two threads write the same pixel
+    auto const compositeBand = [&](int const first, int const last,
+                                   unsigned const chunk) {
+        float* const src = mTextScratch.data() + 2 * rowBytes * chunk;
+        float* const weight = src + rowBytes;
+
+        for (auto const& glyph : mPlacedGlyphs)
+        {
+            GlyphQuad const& q = glyph.quad;
+            int x0, x1, y0, y1;
+            CoveredPixels(q.left, q.right, static_cast<int>(mWidth), x0, x1);
+            CoveredPixels(q.bottom, q.top, static_cast<int>(mHeight), y0, y1);
+            y0 = std::max(y0, first);
+            y1 = std::min(y1, last);
+            if (x0 >= x1 || y0 >= y1)
+            {
+                continue;
+            }
+
+            float const color[4] = {glyph.color.r * 255.0f,
+                                    glyph.color.g * 255.0f,
+                                    glyph.color.b * 255.0f, 0.0f};
+            float const du = (q.uRight - q.uLeft) / (q.right - q.left);
+            float const dv = (q.vTop - q.vBottom) / (q.top - q.bottom);
+
+            for (int y = y0; y < y1; ++y)
+            {
+                float const v = q.vBottom + (y + 0.5f - q.bottom) * dv;
+                std::size_t n = 0;
+                for (int x = x0; x < x1; ++x)
+                {
+                    float const u = q.uLeft + (x + 0.5f - q.left) * du;
+                    float const coverage =
+                        SampleAtlas(mGlyphAtlas, u, v) / 255.0f;
+                    for (int c = 0; c < mChannels; ++c, ++n)
+                    {
+                        // alpha is blended with the same factors as color
+                        src[n] = c == 3 ? coverage * 255.0f : color[c];
+                        weight[n] = coverage;
+                    }
+                }
+                BlendSpan(mTarget + rowBytes * y +
+                              static_cast<std::size_t>(x0) * mChannels,
+                          src, weight, n);
+            }
+        }
+    };
+    mPool.ParallelFor(static_cast<int>(mHeight), compositeBand, maxChunks);
+}